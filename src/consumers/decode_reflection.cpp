@@ -1,3 +1,6 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -6,7 +9,48 @@
 
 namespace fs = std::filesystem;
 
-int main() {
+// Parse "--name=N" (1 <= N <= 4096) into `out`. Returns false if `arg` is a
+// different flag or N is not such a number.
+static bool ParseCountFlag(const char *arg, const char *name, size_t &out) {
+  size_t n = std::strlen(name);
+  if (std::strncmp(arg, name, n) != 0 || arg[n] != '=') return false;
+  const char *digits = arg + n + 1;
+  // strtoul accepts a sign and wraps negatives, so require plain digits.
+  if (*digits < '0' || *digits > '9') return false;
+  char *end = nullptr;
+  errno = 0;
+  unsigned long v = std::strtoul(digits, &end, 10);
+  if (errno == ERANGE || *end != '\0' || v < 1 || v > 4096) return false;
+  out = static_cast<size_t>(v);
+  return true;
+}
+
+// Parse "--where=<path><op><value>" (op one of == = != < <= > >=) into a
+// filter on a root-relative stats path. Quote it in the shell, since < and >
+// are redirections: '--where=persons.age>60'.
+static bool ParseWhereFlag(const char *arg, std::vector<SelectFilter> &filters) {
+  const char *prefix = "--where=";
+  if (std::strncmp(arg, prefix, std::strlen(prefix)) != 0) return false;
+  std::string expr(arg + std::strlen(prefix));
+  size_t pos = expr.find_first_of("<>!=");
+  if (pos == std::string::npos || pos == 0) return false;
+  bool two = pos + 1 < expr.size() && expr[pos + 1] == '=';
+  std::string op = expr.substr(pos, two ? 2 : 1);
+  SelectFilter f;
+  f.column = expr.substr(0, pos);
+  f.value = expr.substr(pos + op.size());
+  if (op == "=" || op == "==") f.op = SelectFilterOp::Eq;
+  else if (op == "!=") f.op = SelectFilterOp::Ne;
+  else if (op == "<") f.op = SelectFilterOp::Lt;
+  else if (op == "<=") f.op = SelectFilterOp::Le;
+  else if (op == ">") f.op = SelectFilterOp::Gt;
+  else if (op == ">=") f.op = SelectFilterOp::Ge;
+  else return false;
+  filters.push_back(f);
+  return true;
+}
+
+int main(int argc, char **argv) {
   // Discover all generated .bfbs in the reflection output directory and try to
   // find matching .bin files in the current working directory. This keeps the
   // demo flexible as new schemas are added.
@@ -16,12 +60,35 @@ int main() {
       {"reflection/people.bfbs", "people.bin"},
       {"reflection/devices.bfbs", "devices.bin"}
     };
-  
+
+  // --pipeline overlaps file reads, decoding and printing; the stage flags
+  // (--readers=N --decoders=N --writers=N --queue=N) imply it.
+  // '--where=<path><op><value>' skips binaries whose stats sidecar (written by
+  // create_stats) proves no row can match.
+  bool pipelined = false;
+  PipelineOptions opts;
+  std::vector<SelectFilter> shard_filters;
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    if (std::strcmp(arg, "--pipeline") == 0) pipelined = true;
+    else if (ParseCountFlag(arg, "--readers", opts.reader_threads)) pipelined = true;
+    else if (ParseCountFlag(arg, "--decoders", opts.decode_threads)) pipelined = true;
+    else if (ParseCountFlag(arg, "--writers", opts.output_threads)) pipelined = true;
+    else if (ParseCountFlag(arg, "--queue", opts.queue_capacity)) pipelined = true;
+    else if (ParseWhereFlag(arg, shard_filters)) continue;
+    else {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      return 2;
+    }
+  }
+
+  if (pipelined) return DecodeAndPrintPipelined(pairs, opts, shard_filters);
 
   int exit_code = 0;
   for (auto &pr : pairs) {
+       if (!ShardMayMatch(pr.second, shard_filters)) continue;
        exit_code |= DecodeAndPrint(pr.first, pr.second);
-    
+
   }
   return exit_code;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include "flatbuffers/util.h"
 #include "reflection/reflection_printer.h"
 
 int main() {
@@ -46,5 +47,92 @@ int main() {
     }
   }
 
+  // Demo 4: top-2 oldest persons (sort/top-K without materializing every row)
+  {
+    std::vector<uint8_t> out_buf;
+    std::vector<uint8_t> out_bfbs;
+    SelectSort sort;
+    sort.column = "age";
+    sort.descending = true;
+    sort.limit = 2;
+    bool ok = SelectColumnsForFlatbufferSorted("reflection/people.bfbs", "people.bin",
+                                               std::string("persons"),
+                                               std::vector<std::string>{"name", "age"}, sort, out_buf, out_bfbs);
+    if (!ok) { std::cerr << "Sorted select failed for people\n"; }
+    else {
+      std::cout << "--- People top-2 by age ---\n";
+      DecodeAndPrintFromBuffers(std::string(reinterpret_cast<const char*>(out_bfbs.data()), out_bfbs.size()), out_buf);
+    }
+  }
+
+  // Demo 5: two queries over people.bin sharing one scan (the `name` column is read once)
+  {
+    std::vector<SelectQuery> queries(2);
+    queries[0].top_level_vector_field = "persons";
+    queries[0].columns = {"name", "age"};
+    queries[0].filters = {{"age", SelectFilterOp::Ge, "21"}};
+    queries[1].top_level_vector_field = "persons";
+    queries[1].columns = {"name", "address.city"};
+    queries[1].filters = {{"address.city", SelectFilterOp::Eq, "Metropolis"}};
+    std::vector<std::vector<uint8_t>> out_bufs;
+    std::vector<uint8_t> out_bfbs;
+    bool ok = SelectColumnsForFlatbufferBatch("reflection/people.bfbs", "people.bin", queries, out_bufs, out_bfbs);
+    if (!ok) { std::cerr << "Batch select failed for people\n"; }
+    else {
+      std::string bfbs(reinterpret_cast<const char*>(out_bfbs.data()), out_bfbs.size());
+      std::cout << "--- People batch: age >= 21 ---\n";
+      DecodeAndPrintFromBuffers(bfbs, out_bufs[0]);
+      std::cout << "--- People batch: city == Metropolis ---\n";
+      DecodeAndPrintFromBuffers(bfbs, out_bufs[1]);
+    }
+  }
+
+  // Demo 6: page through people.bin two rows at a time with continuation cursors.
+  // Both files are loaded once and every page reads from the same buffers.
+  {
+    std::string people_bfbs, people_bin;
+    if (!flatbuffers::LoadFile("reflection/people.bfbs", true, &people_bfbs) ||
+        !flatbuffers::LoadFile("people.bin", true, &people_bin)) {
+      std::cerr << "Paged select could not load people\n";
+    } else {
+      const uint8_t *data = reinterpret_cast<const uint8_t*>(people_bin.data());
+      SelectPage page;
+      page.limit = 2;
+      std::vector<uint8_t> out_buf;
+      std::vector<uint8_t> out_bfbs;
+      std::string next_cursor;
+      for (int page_no = 1;; ++page_no) {
+        bool ok = SelectColumnsForFlatbufferPage(people_bfbs, data, std::string("persons"),
+                                                 std::vector<std::string>{"name", "age"}, page,
+                                                 out_buf, out_bfbs, next_cursor);
+        if (!ok) { std::cerr << "Paged select failed for people\n"; break; }
+        std::cout << "--- People page " << page_no << " ---\n";
+        DecodeAndPrintFromBuffers(std::string(reinterpret_cast<const char*>(out_bfbs.data()), out_bfbs.size()), out_buf);
+        if (next_cursor.empty()) break;
+        page.cursor = next_cursor;
+      }
+    }
+  }
+
+  // Demo 7: hash join persons with persons living in the same city
+  {
+    JoinSide left;
+    left.bfbs_path = "reflection/people.bfbs";
+    left.bin_path = "people.bin";
+    left.vector_field = "persons";
+    left.key_column = "address.city";
+    left.columns = {"name", "address.city"};
+    JoinSide right = left;
+    right.columns = {"name"};
+    std::vector<uint8_t> out_buf;
+    std::vector<uint8_t> out_bfbs;
+    bool ok = HashJoinFlatbuffers(left, right, out_buf, out_bfbs);
+    if (!ok) { std::cerr << "Hash join failed for people\n"; }
+    else {
+      std::cout << "--- People joined on address.city ---\n";
+      DecodeAndPrintFromBuffers(std::string(reinterpret_cast<const char*>(out_bfbs.data()), out_bfbs.size()), out_buf);
+    }
+  }
+
   return 0;
 }
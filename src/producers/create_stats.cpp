@@ -0,0 +1,42 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "reflection/reflection_printer.h"
+
+// Write "<bin>.stats" zone-map sidecars so batch selects and decodes can skip
+// shards whose rows cannot match a filter.
+//
+//   create_stats                             # stats for the example binaries
+//   create_stats <bfbs> <bin> <path>...      # stats for one binary
+//
+// Then quote the filter so the shell does not treat > as a redirection:
+//
+//   decode_reflection '--where=persons.age>60'
+int main(int argc, char **argv) {
+  if (argc > 1) {
+    if (argc < 4) {
+      std::cerr << "usage: create_stats <bfbs> <bin> <path>...\n";
+      return 2;
+    }
+    std::vector<std::string> paths(argv + 3, argv + argc);
+    return WriteShardStats(argv[1], argv[2], paths) ? 0 : 1;
+  }
+
+  struct Shard {
+    const char *bfbs;
+    const char *bin;
+    std::vector<std::string> paths;
+  };
+  std::vector<Shard> shards = {
+    {"reflection/telemetry.bfbs", "telemetry.bin", {"timestamp", "device_id", "sensors.value"}},
+    {"reflection/people.bfbs", "people.bin", {"persons.id", "persons.age", "persons.name", "persons.address.city"}},
+    {"reflection/devices.bfbs", "devices.bin", {"devices.device_id", "devices.online", "devices.readings.value"}},
+    {"reflection/shapeholders.bfbs", "shapeholders.bin", {"holders.id", "holders.color"}}
+  };
+
+  int rc = 0;
+  for (const auto &shard : shards) {
+    if (!WriteShardStats(shard.bfbs, shard.bin, shard.paths)) rc = 1;
+  }
+  return rc;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Thread counts and queue depth for the read -> decode -> output pipeline.
+// Every count is clamped to at least one thread.
+struct PipelineOptions {
+  size_t reader_threads = 1;
+  size_t decode_threads = 1;
+  size_t output_threads = 1;
+  // Capacity of each inter-stage queue (rounded up to a power of two). This
+  // also bounds how many files the reader stage prefetches ahead of decode.
+  size_t queue_capacity = 8;
+  // When true the output stage hands items to the emit callback in input
+  // order; otherwise they are emitted as soon as they are decoded. Ordered
+  // runs keep at most `queue_capacity` items in flight past the oldest one
+  // not yet emitted, so one slow item bounds, rather than grows, buffering.
+  bool ordered_output = true;
+};
+
+// Bounded multi-producer/multi-consumer lock-free queue (Vyukov ring buffer).
+// TryPush/TryPop never block; RunPipeline parks threads on a WaitGate when a
+// queue is full or empty.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity) cap <<= 1;
+    mask_ = cap - 1;
+    cells_.reset(new Cell[cap]);
+    for (size_t i = 0; i < cap; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+  }
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  // Returns false (leaving `value` untouched) when the queue is full.
+  bool TryPush(T &value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      size_t seq = cell->seq.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Returns false when the queue is empty.
+  bool TryPop(T &value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      size_t seq = cell->seq.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->value);
+    cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> seq;
+    T value;
+  };
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_ = 0;
+  alignas(64) std::atomic<size_t> head_;
+  alignas(64) std::atomic<size_t> tail_;
+};
+
+namespace pipeline_detail {
+
+template <typename T>
+struct Slot {
+  size_t index = 0;
+  T value{};
+};
+
+// Blocks a stage thread until a condition on lock-free state holds. Waiters
+// spin briefly, then park on a condition variable so idle stages do not take
+// CPU from busy ones. Whoever changes the state calls Notify(), which only
+// touches the mutex when someone is parked.
+class WaitGate {
+ public:
+  template <typename Pred>
+  void Wait(Pred pred) {
+    for (int i = 0; i < kSpins; ++i) {
+      if (pred()) return;
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mu_);
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    // Pairs with the fence in Notify: either the notifier sees this waiter or
+    // the predicate below sees the notifier's state change.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // The timeout only bounds the cost of a missed wakeup; normal wakeups come
+    // from Notify.
+    while (!cv_.wait_for(lock, std::chrono::milliseconds(50), pred)) {
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void Notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) == 0) return;
+    std::lock_guard<std::mutex> lock(mu_);
+    cv_.notify_all();
+  }
+
+ private:
+  static constexpr int kSpins = 64;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::atomic<int> waiters_{0};
+};
+
+// A BoundedQueue plus the gates its producers and consumers park on.
+template <typename T>
+struct StageQueue {
+  explicit StageQueue(size_t capacity) : q(capacity) {}
+  BoundedQueue<Slot<T>> q;
+  WaitGate not_full;
+  WaitGate not_empty;
+  std::atomic<bool> upstream_done{false};
+};
+
+template <typename T>
+void PushBlocking(StageQueue<T> &sq, Slot<T> &slot) {
+  sq.not_full.Wait([&]() { return sq.q.TryPush(slot); });
+  sq.not_empty.Notify();
+}
+
+// Pop the next slot, waiting while the upstream stage is still running.
+// Returns false once upstream has finished and the queue is drained.
+template <typename T>
+bool PopOrFinish(StageQueue<T> &sq, Slot<T> &slot) {
+  bool got = false;
+  sq.not_empty.Wait([&]() {
+    if (sq.q.TryPop(slot)) {
+      got = true;
+      return true;
+    }
+    if (sq.upstream_done.load(std::memory_order_acquire)) {
+      got = sq.q.TryPop(slot);
+      return true;
+    }
+    return false;
+  });
+  if (got) sq.not_full.Notify();
+  return got;
+}
+
+// Mark one upstream worker finished; the last one closes the queue and wakes
+// every parked consumer.
+template <typename T>
+void FinishWorker(std::atomic<size_t> &remaining, StageQueue<T> &sq) {
+  if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    sq.upstream_done.store(true, std::memory_order_release);
+    sq.not_empty.Notify();
+  }
+}
+
+}  // namespace pipeline_detail
+
+// Run `item_count` items through three overlapping stages:
+//   read(index) -> Loaded            (reader threads, prefetching ahead)
+//   decode(index, Loaded&) -> Decoded (decode threads)
+//   emit(index, Decoded&)            (output threads)
+// Stages are connected by BoundedQueue so a slow stage applies backpressure
+// to the one before it. With `ordered_output` the emit callback is invoked
+// serially in index order; otherwise it may be called concurrently and must
+// be thread-safe. Callbacks must not throw.
+template <typename Loaded, typename Decoded, typename ReadFn, typename DecodeFn, typename EmitFn>
+void RunPipeline(size_t item_count, ReadFn read, DecodeFn decode, EmitFn emit, const PipelineOptions &opts) {
+  using pipeline_detail::FinishWorker;
+  using pipeline_detail::PopOrFinish;
+  using pipeline_detail::PushBlocking;
+  using pipeline_detail::Slot;
+  using pipeline_detail::StageQueue;
+  if (item_count == 0) return;
+
+  size_t n_readers = opts.reader_threads ? opts.reader_threads : 1;
+  size_t n_decoders = opts.decode_threads ? opts.decode_threads : 1;
+  size_t n_outputs = opts.output_threads ? opts.output_threads : 1;
+
+  StageQueue<Loaded> loaded_q(opts.queue_capacity);
+  StageQueue<Decoded> decoded_q(opts.queue_capacity);
+  std::atomic<size_t> next_item{0};
+  std::atomic<size_t> readers_left{n_readers};
+  std::atomic<size_t> decoders_left{n_decoders};
+
+  // Reorder buffer used when output must follow input order. Readers may
+  // only claim items inside [next_emit, next_emit + window), so a slow item
+  // stalls the pipeline instead of letting `pending` grow without bound.
+  std::mutex order_mu;
+  std::map<size_t, Decoded> pending;
+  std::atomic<size_t> next_emit{0};
+  pipeline_detail::WaitGate window_open;
+  const size_t window = opts.queue_capacity ? opts.queue_capacity : 1;
+
+  std::vector<std::thread> threads;
+  threads.reserve(n_readers + n_decoders + n_outputs);
+
+  for (size_t t = 0; t < n_readers; ++t) {
+    threads.emplace_back([&]() {
+      for (;;) {
+        size_t i = next_item.fetch_add(1, std::memory_order_relaxed);
+        if (i >= item_count) break;
+        if (opts.ordered_output) {
+          window_open.Wait([&]() { return i < next_emit.load(std::memory_order_acquire) + window; });
+        }
+        Slot<Loaded> slot;
+        slot.index = i;
+        slot.value = read(i);
+        PushBlocking(loaded_q, slot);
+      }
+      FinishWorker(readers_left, loaded_q);
+    });
+  }
+
+  for (size_t t = 0; t < n_decoders; ++t) {
+    threads.emplace_back([&]() {
+      Slot<Loaded> in;
+      while (PopOrFinish(loaded_q, in)) {
+        Slot<Decoded> out;
+        out.index = in.index;
+        out.value = decode(in.index, in.value);
+        in.value = Loaded{};
+        PushBlocking(decoded_q, out);
+      }
+      FinishWorker(decoders_left, decoded_q);
+    });
+  }
+
+  for (size_t t = 0; t < n_outputs; ++t) {
+    threads.emplace_back([&]() {
+      Slot<Decoded> in;
+      while (PopOrFinish(decoded_q, in)) {
+        if (!opts.ordered_output) {
+          emit(in.index, in.value);
+          continue;
+        }
+        std::lock_guard<std::mutex> lock(order_mu);
+        pending.emplace(in.index, std::move(in.value));
+        size_t emitted = next_emit.load(std::memory_order_relaxed);
+        for (auto it = pending.begin(); it != pending.end() && it->first == emitted; it = pending.begin()) {
+          emit(it->first, it->second);
+          pending.erase(it);
+          next_emit.store(++emitted, std::memory_order_release);
+        }
+        window_open.Notify();
+      }
+    });
+  }
+
+  for (auto &th : threads) th.join();
+}
@@ -1,11 +1,36 @@
 #include "reflection_printer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <functional>
+#include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include "flatbuffers/util.h"
 #include "flatbuffers/idl.h"
 
-// Per-field enum cache: map field pointer -> map(value -> name)
-static std::unordered_map<const reflection::Field*, std::unordered_map<int64_t, const char*>> g_field_enum_cache;
+// Per-field enum cache: map field pointer -> map(value -> name). Thread-local so
+// pipelined decode workers can resolve enums without locking.
+static thread_local std::unordered_map<const reflection::Field*, std::unordered_map<int64_t, const char*>> g_field_enum_cache;
+static thread_local int g_enum_cache_depth = 0;
+
+// Keys and names point into a schema buffer, so the cache must not outlive
+// it. Every print or select pass over a live schema holds one of these; the
+// outermost one empties the thread's cache on exit, before the caller can
+// free the schema and load another at the same address.
+struct EnumCacheScope {
+  EnumCacheScope() { ++g_enum_cache_depth; }
+  ~EnumCacheScope() {
+    if (--g_enum_cache_depth == 0) g_field_enum_cache.clear();
+  }
+  EnumCacheScope(const EnumCacheScope &) = delete;
+  EnumCacheScope &operator=(const EnumCacheScope &) = delete;
+};
 
 // Build per-field enum mapping on first access. Returns nullptr if none.
 static const char *FindEnumNameForField(const reflection::Schema *schema, const reflection::Field *field, int64_t value) {
@@ -58,12 +83,14 @@ static const char *FindEnumNameForField(const reflection::Schema *schema, const
 void PrintTable(const reflection::Schema *schema,
                 const reflection::Object *obj,
                 const flatbuffers::Table *t,
-                int indent) {
+                int indent,
+                std::ostream &os) {
+  EnumCacheScope enum_scope;
   if (!schema || !obj || !t) return;
   for (auto it = obj->fields()->begin(); it != obj->fields()->end(); ++it) {
     auto field = *it;
-    for (int i = 0; i < indent; ++i) std::cout << "  ";
-    std::cout << field->name()->c_str() << " : ";
+    for (int i = 0; i < indent; ++i) os << "  ";
+    os << field->name()->c_str() << " : ";
 
     auto btype = field->type()->base_type();
     switch (btype) {
@@ -87,24 +114,24 @@ void PrintTable(const reflection::Schema *schema,
 
         if (disc_val >= 0 && disc_field) {
           const char *ename = FindEnumNameForField(schema, disc_field, disc_val);
-          if (ename) std::cout << "(" << disc_field->name()->c_str() << ": " << ename << ")\n";
-          else std::cout << "(" << disc_field->name()->c_str() << ": " << disc_val << ")\n";
+          if (ename) os << "(" << disc_field->name()->c_str() << ": " << ename << ")\n";
+          else os << "(" << disc_field->name()->c_str() << ": " << disc_val << ")\n";
         }
 
         // Use the helper GetUnionType where possible to obtain the concrete object schema
         try {
           auto &member_obj = flatbuffers::GetUnionType(*schema, *obj, *field, *t);
           auto member_table = flatbuffers::GetFieldT(*t, *field);
-          if (!member_table) { for (int i=0;i<indent;i++) std::cout<<"  "; std::cout << "null\n"; break; }
+          if (!member_table) { for (int i=0;i<indent;i++) os<<"  "; os << "null\n"; break; }
           // print concrete object type name if available
           if (member_obj.name() && member_obj.name()->c_str()) {
-            for (int i=0;i<indent;i++) std::cout<<"  ";
-            std::cout << "(concrete: " << member_obj.name()->c_str() << ")\n";
+            for (int i=0;i<indent;i++) os<<"  ";
+            os << "(concrete: " << member_obj.name()->c_str() << ")\n";
           }
-          PrintTable(schema, &member_obj, member_table, indent+1);
+          PrintTable(schema, &member_obj, member_table, indent+1, os);
         } catch (...) {
-          for (int i=0;i<indent;i++) std::cout<<"  ";
-          std::cout << "<union (unresolved)>\n";
+          for (int i=0;i<indent;i++) os<<"  ";
+          os << "<union (unresolved)>\n";
         }
         break;
       }
@@ -119,45 +146,45 @@ void PrintTable(const reflection::Schema *schema,
       case reflection::ULong: {
   int64_t v = flatbuffers::GetAnyFieldI(*t, *field);
   const char *ename = FindEnumNameForField(schema, field, v);
-  if (ename) std::cout << v << " (" << ename << ")\n";
-  else std::cout << v << "\n";
+  if (ename) os << v << " (" << ename << ")\n";
+  else os << v << "\n";
         break;
       }
       case reflection::Float:
       case reflection::Double: {
         double v = flatbuffers::GetAnyFieldF(*t, *field);
-        std::cout << v << "\n";
+        os << v << "\n";
         break;
       }
       case reflection::String: {
         auto s = flatbuffers::GetFieldS(*t, *field);
-        if (s) std::cout << '"' << s->str() << '"' << "\n";
-        else std::cout << "null\n";
+        if (s) os << '"' << s->str() << '"' << "\n";
+        else os << "null\n";
         break;
       }
       case reflection::Vector: {
         auto vec_any = flatbuffers::GetFieldAnyV(*t, *field);
-        if (!vec_any) { std::cout << "[]\n"; break; }
+        if (!vec_any) { os << "[]\n"; break; }
         auto elem_type = field->type()->element();
-        std::cout << "[\n";
+        os << "[\n";
         size_t len = vec_any->size();
         for (size_t i = 0; i < len; ++i) {
-          for (int j = 0; j < indent+1; ++j) std::cout << "  ";
+          for (int j = 0; j < indent+1; ++j) os << "  ";
           auto ebt = static_cast<reflection::BaseType>(elem_type);
           if (flatbuffers::IsScalar(ebt)) {
             if (flatbuffers::IsInteger(ebt)) {
               int64_t ev = flatbuffers::GetAnyVectorElemI(vec_any, ebt, i);
               // For vectors, we attempt to use the parent field to resolve enum values
               const char *ename = FindEnumNameForField(schema, field, ev);
-              if (ename) std::cout << ev << " (" << ename << ")\n";
-              else std::cout << ev << "\n";
+              if (ename) os << ev << " (" << ename << ")\n";
+              else os << ev << "\n";
             } else if (flatbuffers::IsFloat(ebt)) {
-              std::cout << flatbuffers::GetAnyVectorElemF(vec_any, ebt, i) << "\n";
+              os << flatbuffers::GetAnyVectorElemF(vec_any, ebt, i) << "\n";
             } else {
-              std::cout << flatbuffers::GetAnyVectorElemS(vec_any, ebt, i) << "\n";
+              os << flatbuffers::GetAnyVectorElemS(vec_any, ebt, i) << "\n";
             }
           } else if (ebt == reflection::String) {
-            std::cout << '"' << flatbuffers::GetAnyVectorElemS(vec_any, ebt, i) << '"' << "\n";
+            os << '"' << flatbuffers::GetAnyVectorElemS(vec_any, ebt, i) << '"' << "\n";
           } else if (ebt == reflection::Obj) {
             auto elem_ptr = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(vec_any, i);
             const flatbuffers::Table *elem_table = elem_ptr;
@@ -165,26 +192,26 @@ void PrintTable(const reflection::Schema *schema,
               int type_index = field->type()->index();
               if (type_index >= 0 && schema->objects() && type_index < schema->objects()->size()) {
                 auto child_obj = schema->objects()->Get(type_index);
-                PrintTable(schema, child_obj, elem_table, indent+2);
+                PrintTable(schema, child_obj, elem_table, indent+2, os);
               } else {
-                std::cout << "  <nested table>\n";
+                os << "  <nested table>\n";
               }
             } else {
-              std::cout << "null\n";
+              os << "null\n";
             }
           } else {
-            std::cout << "<unsupported vector elem>\n";
+            os << "<unsupported vector elem>\n";
           }
         }
-        for (int j = 0; j < indent; ++j) std::cout << "  ";
-        std::cout << "]\n";
+        for (int j = 0; j < indent; ++j) os << "  ";
+        os << "]\n";
         break;
       }
       case reflection::Obj: {
         // Support unions: many schemas present a sibling "<name>_type" discriminator.
         auto sub = flatbuffers::GetFieldT(*t, *field);
-        std::cout << "\n";
-        if (!sub) { std::cout << "null\n"; break; }
+        os << "\n";
+        if (!sub) { os << "null\n"; break; }
 
         // Try to find a discriminator field (heuristic): name + "_type" or name + "Type"
         const char *disc_name1 = (std::string(field->name()->c_str()) + "_type").c_str();
@@ -213,26 +240,40 @@ void PrintTable(const reflection::Schema *schema,
               break;
             }
           }
-          if (ename) std::cout << "(union type: " << ename << ")\n";
-          else std::cout << "(union type: " << disc_val << ")\n";
+          if (ename) os << "(union type: " << ename << ")\n";
+          else os << "(union type: " << disc_val << ")\n";
         }
 
         int type_index = field->type()->index();
         if (type_index >= 0 && schema->objects() && type_index < schema->objects()->size()) {
           auto child_obj = schema->objects()->Get(type_index);
-          PrintTable(schema, child_obj, sub, indent+1);
+          PrintTable(schema, child_obj, sub, indent+1, os);
         } else {
           // If we cannot find the child object metadata, still attempt to print as nested table
-          PrintTable(schema, /*obj=*/nullptr, sub, indent+1);
+          PrintTable(schema, /*obj=*/nullptr, sub, indent+1, os);
         }
         break;
       }
       default:
-        std::cout << "<unsupported type>\n";
+        os << "<unsupported type>\n";
     }
   }
 }
 
+// Print one already-loaded binary, including the "--- Decoding" banner.
+static void PrintDecoded(const reflection::Schema *schema,
+                         const std::string &bfbs_path,
+                         const std::string &bin_path,
+                         const std::string &data,
+                         std::ostream &os) {
+  const uint8_t *buf = reinterpret_cast<const uint8_t *>(data.c_str());
+  auto table = flatbuffers::GetAnyRoot(buf);
+  auto root_obj = schema->root_table();
+  os << "--- Decoding: " << bfbs_path << " + " << bin_path << " ---\n";
+  PrintTable(schema, root_obj, table, 0, os);
+  os << std::endl;
+}
+
 int DecodeAndPrint(const std::string &bfbs_path, const std::string &bin_path) {
   std::string bfbs_data;
   if (!flatbuffers::LoadFile(bfbs_path.c_str(), true, &bfbs_data)) {
@@ -258,15 +299,79 @@ int DecodeAndPrint(const std::string &bfbs_path, const std::string &bin_path) {
     return 1;
   }
 
-  const uint8_t *buf = reinterpret_cast<const uint8_t *>(data.c_str());
-  auto table = flatbuffers::GetAnyRoot(buf);
-  auto root_obj = schema->root_table();
-  std::cout << "--- Decoding: " << bfbs_path << " + " << bin_path << " ---\n";
-  PrintTable(schema, root_obj, table, 0);
-  std::cout << std::endl;
+  PrintDecoded(schema, bfbs_path, bin_path, data, std::cout);
   return 0;
 }
 
+int DecodeAndPrintPipelined(const std::vector<std::pair<std::string, std::string>> &pairs,
+                            const PipelineOptions &opts,
+                            const std::vector<SelectFilter> &shard_filters) {
+  // Load and validate each distinct schema once; workers only read them.
+  std::unordered_map<std::string, std::string> bfbs_by_path;
+  int rc = 0;
+  for (const auto &pr : pairs) {
+    if (bfbs_by_path.count(pr.first)) continue;
+    std::string bfbs_data;
+    if (!flatbuffers::LoadFile(pr.first.c_str(), true, &bfbs_data)) {
+      std::cerr << "Failed to load bfbs file: " << pr.first << "\n";
+      rc = 1;
+    } else {
+      flatbuffers::Parser parser;
+      auto schema = reflection::GetSchema(bfbs_data.c_str());
+      if (!schema || !parser.Deserialize(schema)) {
+        std::cerr << "Failed to deserialize bfbs into Parser: " << pr.first << std::endl;
+        bfbs_data.clear();
+        rc = 1;
+      }
+    }
+    bfbs_by_path.emplace(pr.first, std::move(bfbs_data));
+  }
+
+  struct LoadedBin {
+    bool ok = false;
+    bool skipped = false;
+    std::string data;
+  };
+  struct DecodedBin {
+    std::string out;
+    std::string err;
+  };
+
+  auto read = [&](size_t i) {
+    LoadedBin loaded;
+    if (bfbs_by_path.at(pairs[i].first).empty()) return loaded;
+    if (!ShardMayMatch(pairs[i].second, shard_filters)) {
+      loaded.skipped = true;
+      return loaded;
+    }
+    loaded.ok = flatbuffers::LoadFile(pairs[i].second.c_str(), true, &loaded.data);
+    return loaded;
+  };
+  auto decode = [&](size_t i, LoadedBin &loaded) {
+    DecodedBin decoded;
+    const std::string &bfbs_data = bfbs_by_path.at(pairs[i].first);
+    if (bfbs_data.empty() || loaded.skipped) return decoded;
+    if (!loaded.ok) {
+      // Non-fatal, as in DecodeAndPrint
+      decoded.err = "Failed to load data file: " + pairs[i].second + "\n";
+      return decoded;
+    }
+    std::ostringstream os;
+    PrintDecoded(reflection::GetSchema(bfbs_data.c_str()), pairs[i].first, pairs[i].second, loaded.data, os);
+    decoded.out = os.str();
+    return decoded;
+  };
+  std::mutex emit_mu;
+  auto emit = [&](size_t, DecodedBin &decoded) {
+    std::lock_guard<std::mutex> lock(emit_mu);
+    if (!decoded.err.empty()) std::cerr << decoded.err;
+    if (!decoded.out.empty()) std::cout << decoded.out << std::flush;
+  };
+
+  RunPipeline<LoadedBin, DecodedBin>(pairs.size(), read, decode, emit, opts);
+  return rc;
+}
+
 // Helper: find a field by name in an object descriptor
 static const reflection::Field *FindFieldByName(const reflection::Object *obj, const std::string &name) {
   if (!obj || !obj->fields()) return nullptr;
@@ -279,6 +384,7 @@ static const reflection::Field *FindFieldByName(const reflection::Object *obj, c
 }
 
 #include "select_result_generated.h"
+#include "shard_stats_generated.h"
 
 // Helper: split a path like "address.city" into components
 static std::vector<std::string> SplitPath(const std::string &path) {
@@ -334,159 +440,1445 @@ static const reflection::Field *ResolveNestedField(const reflection::Schema *sch
   return nullptr;
 }
 
-bool SelectColumnsForFlatbuffer(const std::string &bfbs_path,
-                                const std::string &bin_path,
-                                const std::string &top_level_vector_field,
-                                const std::vector<std::string> &columns,
-                                std::vector<uint8_t> &out_buffer,
-                                std::vector<uint8_t> &out_bfbs_buffer) {
-  out_buffer.clear();
-  out_bfbs_buffer.clear();
-  std::string bfbs_data;
-  if (!flatbuffers::LoadFile(bfbs_path.c_str(), true, &bfbs_data)) {
-    std::cerr << "SelectColumns: failed to load bfbs: " << bfbs_path << "\n";
-    return false;
-  }
-  auto schema = reflection::GetSchema(bfbs_data.c_str());
-  if (!schema) {
-    std::cerr << "SelectColumns: failed to parse bfbs schema\n";
-    return false;
-  }
-  std::string data;
-  if (!flatbuffers::LoadFile(bin_path.c_str(), true, &data)) {
-    std::cerr << "SelectColumns: failed to load bin: " << bin_path << "\n";
-    return false;
-  }
-
-  const uint8_t *buf = reinterpret_cast<const uint8_t *>(data.c_str());
-  auto root_table = flatbuffers::GetAnyRoot(buf);
-  auto root_obj = schema->root_table();
-  if (!root_obj || !root_obj->fields()) {
-    std::cerr << "SelectColumns: root_obj or fields missing\n";
+// Load the generated select_result.bfbs so callers can introspect results in-memory.
+static bool LoadSelectResultBfbs(std::vector<uint8_t> &out_bfbs_buffer) {
+  std::string gen_bfbs;
+  if (!flatbuffers::LoadFile("reflection/select_result.bfbs", true, &gen_bfbs)) {
+    std::cerr << "SelectColumns: failed to load generated select_result.bfbs\n";
     return false;
   }
+  out_bfbs_buffer.assign(reinterpret_cast<const uint8_t*>(gen_bfbs.c_str()), reinterpret_cast<const uint8_t*>(gen_bfbs.c_str()) + gen_bfbs.size());
+  return true;
+}
 
-  // Locate the vector-of-objects field. If the caller supplied a name, use it;
-  // otherwise fall back to the old heuristic of picking the first vector-of-objects.
+// Locate the vector-of-objects field in the root object. If a name is given,
+// use it; otherwise fall back to the first vector-of-objects field.
+static const reflection::Field *FindTopLevelVectorField(const reflection::Object *root_obj,
+                                                        const std::string &top_level_vector_field) {
   const reflection::Field *vec_field = nullptr;
   if (!top_level_vector_field.empty()) {
     vec_field = FindFieldByName(root_obj, top_level_vector_field);
     if (vec_field && !(vec_field->type() && vec_field->type()->base_type() == reflection::Vector && vec_field->type()->element() == reflection::Obj)) {
       std::cerr << "SelectColumns: specified top-level field '" << top_level_vector_field << "' is not a vector-of-objects\n";
-      return false;
+      return nullptr;
     }
+    if (vec_field) return vec_field;
   }
-  if (!vec_field) {
-    for (auto it = root_obj->fields()->begin(); it != root_obj->fields()->end(); ++it) {
-      auto f = *it;
-      if (!f || !f->type()) continue;
-      if (f->type()->base_type() == reflection::Vector && f->type()->element() == reflection::Obj) {
-        vec_field = f;
-        break;
-      }
+  for (auto it = root_obj->fields()->begin(); it != root_obj->fields()->end(); ++it) {
+    auto f = *it;
+    if (!f || !f->type()) continue;
+    if (f->type()->base_type() == reflection::Vector && f->type()->element() == reflection::Obj) {
+      return f;
     }
   }
-  if (!vec_field) {
-    std::cerr << "SelectColumns: no top-level vector-of-objects field found in root\n";
+  std::cerr << "SelectColumns: no top-level vector-of-objects field found in root\n";
+  return nullptr;
+}
+
+// The vector a select reads from, plus the object type of its elements.
+struct SourceVector {
+  const reflection::Field *field = nullptr;
+  const flatbuffers::VectorOfAny *vec = nullptr;
+  const reflection::Object *child_obj = nullptr;
+};
+
+// Object type of the elements of a vector-of-objects field, or nullptr.
+static const reflection::Object *VectorElementObject(const reflection::Schema *schema,
+                                                     const reflection::Field *vec_field) {
+  int child_type_index = vec_field->type()->index();
+  if (child_type_index < 0 || !schema->objects() || child_type_index >= schema->objects()->size()) return nullptr;
+  return schema->objects()->Get(child_type_index);
+}
+
+// Resolve the top-level vector-of-objects of an already-loaded binary.
+static bool LocateSourceVector(const reflection::Schema *schema,
+                               const uint8_t *buf,
+                               const std::string &top_level_vector_field,
+                               SourceVector &out) {
+  auto root_table = flatbuffers::GetAnyRoot(buf);
+  auto root_obj = schema->root_table();
+  if (!root_obj || !root_obj->fields()) {
+    std::cerr << "SelectColumns: root_obj or fields missing\n";
     return false;
   }
 
+  const reflection::Field *vec_field = FindTopLevelVectorField(root_obj, top_level_vector_field);
+  if (!vec_field) return false;
+  out.field = vec_field;
+
   // Obtain the vector<Table> pointer
-  auto vec_any = flatbuffers::GetFieldAnyV(*root_table, *vec_field);
-  if (!vec_any) {
+  out.vec = flatbuffers::GetFieldAnyV(*root_table, *vec_field);
+  if (!out.vec) {
     std::cerr << "SelectColumns: GetFieldAnyV returned null for vector field\n";
     return false;
   }
-  size_t len = vec_any->size();
 
-  // Pre-resolve requested fields in the child object descriptor (the vector's object type)
-  int child_type_index = vec_field->type()->index();
-  const reflection::Object *child_obj = nullptr;
-  if (child_type_index >= 0 && schema->objects() && child_type_index < schema->objects()->size()) {
-    child_obj = schema->objects()->Get(child_type_index);
-  }
-  if (!child_obj) {
+  // Resolve the child object descriptor (the vector's object type)
+  out.child_obj = VectorElementObject(schema, vec_field);
+  if (!out.child_obj) {
     std::cerr << "SelectColumns: failed to resolve child object type for vector elements\n";
     return false;
   }
+  return true;
+}
+
+// A column value read with its native type, before any string formatting.
+// Enums and bools read as Int; only ULong uses UInt. Strings point into the
+// source buffer, so a ColumnValue is only valid while that buffer is alive.
+struct ColumnValue {
+  enum Kind { Null, Int, UInt, Float, Str } kind = Null;
+  int64_t i = 0;
+  uint64_t u = 0;
+  double f = 0;
+  std::string_view s;
+};
+
+// NaN is unordered; filters, stats, sorts and joins treat it like a missing value.
+static bool IsNaN(const ColumnValue &v) {
+  return v.kind == ColumnValue::Float && std::isnan(v.f);
+}
+
+// Read one scalar/string field of `table` into `out` (Null if absent).
+static void ReadFieldValue(const flatbuffers::Table &table, const reflection::Field &field, ColumnValue &out) {
+  out = ColumnValue();
+  switch (field.type()->base_type()) {
+    case reflection::String: {
+      auto s = flatbuffers::GetFieldS(table, field);
+      if (s) {
+        out.kind = ColumnValue::Str;
+        out.s = std::string_view(s->c_str(), s->size());
+      }
+      break;
+    }
+    case reflection::ULong:
+      out.kind = ColumnValue::UInt;
+      out.u = static_cast<uint64_t>(flatbuffers::GetAnyFieldI(table, field));
+      break;
+    case reflection::Bool:
+    case reflection::Byte:
+    case reflection::UByte:
+    case reflection::Short:
+    case reflection::UShort:
+    case reflection::Int:
+    case reflection::UInt:
+    case reflection::Long:
+      out.kind = ColumnValue::Int;
+      out.i = flatbuffers::GetAnyFieldI(table, field);
+      break;
+    case reflection::Float:
+    case reflection::Double:
+      out.kind = ColumnValue::Float;
+      out.f = flatbuffers::GetAnyFieldF(table, field);
+      break;
+    default:
+      break;
+  }
+}
+
+// Read the value at `path` below `table`. Returns the leaf field descriptor
+// (needed for enum names) or nullptr if the path is missing.
+static const reflection::Field *ReadColumnValue(const reflection::Schema *schema,
+                                                const reflection::Object *obj,
+                                                const flatbuffers::Table *table,
+                                                const std::vector<std::string> &path,
+                                                ColumnValue &out) {
+  out = ColumnValue();
+  if (!table) return nullptr;
+  const flatbuffers::Table *value_table = nullptr;
+  const reflection::Field *field = ResolveNestedField(schema, obj, table, path, value_table);
+  if (!field || !value_table) return nullptr;
+  ReadFieldValue(*value_table, *field, out);
+  return field;
+}
+
+// Format a column value as a select_result cell: enum names where the field
+// has one, decimal numbers otherwise, and "" for missing values.
+static flatbuffers::Offset<flatbuffers::String> CreateCell(flatbuffers::FlatBufferBuilder &fbb,
+                                                           const reflection::Schema *schema,
+                                                           const reflection::Field *field,
+                                                           const ColumnValue &v) {
+  switch (v.kind) {
+    case ColumnValue::Str:
+      return fbb.CreateString(v.s.data(), v.s.size());
+    case ColumnValue::Int: {
+      const char *ename = FindEnumNameForField(schema, field, v.i);
+      if (ename) return fbb.CreateString(std::string(ename));
+      return fbb.CreateString(std::to_string(v.i));
+    }
+    case ColumnValue::UInt:
+      return fbb.CreateString(std::to_string(v.u));
+    case ColumnValue::Float:
+      return fbb.CreateString(std::to_string(v.f));
+    default:
+      return fbb.CreateString(std::string(""));
+  }
+}
+
+// Build one result row for a vector element. A null element yields an empty row.
+static flatbuffers::Offset<selectresult::Row> CreateSelectRow(flatbuffers::FlatBufferBuilder &fbb,
+                                                              const reflection::Schema *schema,
+                                                              const reflection::Object *child_obj,
+                                                              const flatbuffers::Table *elem,
+                                                              const std::vector<std::vector<std::string>> &col_paths) {
+  std::vector<flatbuffers::Offset<flatbuffers::String>> col_strs;
+  if (elem) {
+    col_strs.reserve(col_paths.size());
+    ColumnValue v;
+    for (const auto &path : col_paths) {
+      const reflection::Field *field = ReadColumnValue(schema, child_obj, elem, path, v);
+      col_strs.push_back(CreateCell(fbb, schema, field, v));
+    }
+  }
+  auto vec_off = fbb.CreateVector(col_strs);
+  return selectresult::CreateRow(fbb, vec_off);
+}
 
-  // Pre-split column paths (may be nested like "address.city")
+// Finish a select_result Result from its rows and copy it out.
+static void FinishSelectResult(flatbuffers::FlatBufferBuilder &fbb,
+                               const std::vector<flatbuffers::Offset<selectresult::Row>> &rows_off,
+                               std::vector<uint8_t> &out_buffer) {
+  auto rows_vec = fbb.CreateVector(rows_off);
+  auto root = selectresult::CreateResult(fbb, rows_vec);
+  fbb.Finish(root);
+  out_buffer.assign(fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+// Split each requested column (may be nested like "address.city").
+static std::vector<std::vector<std::string>> SplitColumnPaths(const std::vector<std::string> &columns) {
   std::vector<std::vector<std::string>> col_paths;
   col_paths.reserve(columns.size());
   for (const auto &c : columns) col_paths.push_back(SplitPath(c));
+  return col_paths;
+}
+
+// Run a select against an already-loaded binary. Shared by the single-file
+// and pipelined multi-file entry points.
+static bool SelectColumnsFromBuffer(const reflection::Schema *schema,
+                                    const uint8_t *buf,
+                                    const std::string &top_level_vector_field,
+                                    const std::vector<std::string> &columns,
+                                    std::vector<uint8_t> &out_buffer) {
+  EnumCacheScope enum_scope;
+  out_buffer.clear();
+  SourceVector src;
+  if (!LocateSourceVector(schema, buf, top_level_vector_field, src)) return false;
+  size_t len = src.vec->size();
+  auto col_paths = SplitColumnPaths(columns);
 
   // Build a FlatBuffer Result with rows and cols
   flatbuffers::FlatBufferBuilder fbb;
   std::vector<flatbuffers::Offset<selectresult::Row>> rows_off;
   rows_off.reserve(len);
+  for (size_t i = 0; i < len; ++i) {
+    auto elem_ptr = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(src.vec, i);
+    rows_off.push_back(CreateSelectRow(fbb, schema, src.child_obj, elem_ptr, col_paths));
+  }
+  FinishSelectResult(fbb, rows_off, out_buffer);
+  return true;
+}
+
+// Build a select_result with no rows, returned for shards skipped by stats.
+static void EmptySelectResult(std::vector<uint8_t> &out_buffer) {
+  flatbuffers::FlatBufferBuilder fbb;
+  FinishSelectResult(fbb, {}, out_buffer);
+}
+
+// Load and check a source schema.
+static bool LoadSelectSchema(const std::string &bfbs_path, std::string &bfbs_data) {
+  if (!flatbuffers::LoadFile(bfbs_path.c_str(), true, &bfbs_data)) {
+    std::cerr << "SelectColumns: failed to load bfbs: " << bfbs_path << "\n";
+    return false;
+  }
+  if (!reflection::GetSchema(bfbs_data.c_str())) {
+    std::cerr << "SelectColumns: failed to parse bfbs schema\n";
+    return false;
+  }
+  return true;
+}
+
+// Load a source schema and binary for the single-file select entry points.
+static bool LoadSelectSources(const std::string &bfbs_path,
+                              const std::string &bin_path,
+                              std::string &bfbs_data,
+                              std::string &data) {
+  if (!LoadSelectSchema(bfbs_path, bfbs_data)) return false;
+  if (!flatbuffers::LoadFile(bin_path.c_str(), true, &data)) {
+    std::cerr << "SelectColumns: failed to load bin: " << bin_path << "\n";
+    return false;
+  }
+  return true;
+}
+
+bool SelectColumnsForFlatbuffer(const std::string &bfbs_path,
+                                const std::string &bin_path,
+                                const std::string &top_level_vector_field,
+                                const std::vector<std::string> &columns,
+                                std::vector<uint8_t> &out_buffer,
+                                std::vector<uint8_t> &out_bfbs_buffer) {
+  out_buffer.clear();
+  out_bfbs_buffer.clear();
+  std::string bfbs_data, data;
+  if (!LoadSelectSources(bfbs_path, bin_path, bfbs_data, data)) return false;
+  auto schema = reflection::GetSchema(bfbs_data.c_str());
+  const uint8_t *buf = reinterpret_cast<const uint8_t *>(data.c_str());
+  if (!SelectColumnsFromBuffer(schema, buf, top_level_vector_field, columns, out_buffer)) return false;
+  return LoadSelectResultBfbs(out_bfbs_buffer);
+}
+
+// Sort entry for numeric columns: the value mapped to an order-preserving
+// unsigned key, plus the element index it came from.
+struct NumericSortEntry {
+  uint64_t key;
+  uint32_t index;
+};
+
+// Sort entry for string columns; the key points into the source buffer.
+struct StringSortEntry {
+  std::string_view key;
+  uint32_t index;
+};
+
+// Map a non-null numeric value onto uint64 so unsigned order matches value order.
+static uint64_t OrderedKey(const ColumnValue &v) {
+  switch (v.kind) {
+    case ColumnValue::Int:
+      return static_cast<uint64_t>(v.i) ^ (1ULL << 63);
+    case ColumnValue::UInt:
+      return v.u;
+    case ColumnValue::Float: {
+      uint64_t bits;
+      std::memcpy(&bits, &v.f, sizeof(bits));
+      return (bits & (1ULL << 63)) ? ~bits : (bits | (1ULL << 63));
+    }
+    default:
+      return 0;
+  }
+}
 
+// Stable LSD radix sort on the 64-bit key, one byte per pass. Passes where
+// every key shares the same byte are skipped, so narrow keys (ages, ids)
+// only pay for the bytes that actually vary.
+static void RadixSort(std::vector<NumericSortEntry> &entries) {
+  if (entries.size() < 2) return;
+  std::vector<NumericSortEntry> tmp(entries.size());
+  for (int shift = 0; shift < 64; shift += 8) {
+    size_t count[257] = {0};
+    for (const auto &e : entries) ++count[((e.key >> shift) & 0xff) + 1];
+    if (count[((entries[0].key >> shift) & 0xff) + 1] == entries.size()) continue;
+    for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+    for (const auto &e : entries) tmp[count[(e.key >> shift) & 0xff]++] = e;
+    entries.swap(tmp);
+  }
+}
+
+// Keep the first `k` entries under `less`, in order, using a bounded max-heap.
+template <typename Entry, typename Less>
+static void KeepTopK(std::vector<Entry> &entries, size_t k, Less less) {
+  std::vector<Entry> heap;
+  heap.reserve(k);
+  for (const auto &e : entries) {
+    if (heap.size() < k) {
+      heap.push_back(e);
+      std::push_heap(heap.begin(), heap.end(), less);
+    } else if (less(e, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), less);
+      heap.back() = e;
+      std::push_heap(heap.begin(), heap.end(), less);
+    }
+  }
+  std::sort_heap(heap.begin(), heap.end(), less);
+  entries.swap(heap);
+}
+
+// Return the element indices of `src` ordered by `sort`, truncated to
+// `sort.limit` when non-zero. Ties keep vector order; missing values and
+// NaN sort last in either direction.
+static void OrderSourceVector(const reflection::Schema *schema,
+                              const SourceVector &src,
+                              const SelectSort &sort,
+                              std::vector<uint32_t> &out_order) {
+  out_order.clear();
+  auto key_path = SplitPath(sort.column);
+  size_t len = src.vec->size();
+  size_t keep = sort.limit ? std::min(sort.limit, len) : len;
+
+  std::vector<uint32_t> nulls;
+  std::vector<NumericSortEntry> numeric;
+  std::vector<StringSortEntry> strings;
+  ColumnValue v;
   for (size_t i = 0; i < len; ++i) {
-    auto elem_ptr = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(vec_any, i);
-    if (!elem_ptr) {
-      // empty row: create an empty vector<Offset<String>>
-      auto empty_vec = fbb.CreateVector<flatbuffers::Offset<flatbuffers::String>>({});
-      rows_off.push_back(selectresult::CreateRow(fbb, empty_vec));
-      continue;
+    auto elem = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(src.vec, i);
+    ReadColumnValue(schema, src.child_obj, elem, key_path, v);
+    uint32_t idx = static_cast<uint32_t>(i);
+    if (v.kind == ColumnValue::Null || IsNaN(v)) {
+      nulls.push_back(idx);
+    } else if (v.kind == ColumnValue::Str) {
+      strings.push_back(StringSortEntry{v.s, idx});
+    } else {
+      uint64_t key = OrderedKey(v);
+      numeric.push_back(NumericSortEntry{sort.descending ? ~key : key, idx});
+    }
+  }
+  // A path resolves to one field, so at most one of `numeric` and `strings`
+  // is non-empty.
+  if (!strings.empty()) {
+    bool desc = sort.descending;
+    auto less = [desc](const StringSortEntry &a, const StringSortEntry &b) {
+      if (a.key != b.key) return desc ? b.key < a.key : a.key < b.key;
+      return a.index < b.index;
+    };
+    if (keep < strings.size()) KeepTopK(strings, keep, less);
+    else std::sort(strings.begin(), strings.end(), less);
+    for (const auto &e : strings) out_order.push_back(e.index);
+  } else if (!numeric.empty()) {
+    auto less = [](const NumericSortEntry &a, const NumericSortEntry &b) {
+      return a.key != b.key ? a.key < b.key : a.index < b.index;
+    };
+    if (keep < numeric.size()) KeepTopK(numeric, keep, less);
+    else RadixSort(numeric);
+    for (const auto &e : numeric) out_order.push_back(e.index);
+  }
+  for (size_t i = 0; i < nulls.size() && out_order.size() < keep; ++i) out_order.push_back(nulls[i]);
+}
+
+bool SelectColumnsForFlatbufferSorted(const std::string &bfbs_path,
+                                      const std::string &bin_path,
+                                      const std::string &top_level_vector_field,
+                                      const std::vector<std::string> &columns,
+                                      const SelectSort &sort,
+                                      std::vector<uint8_t> &out_buffer,
+                                      std::vector<uint8_t> &out_bfbs_buffer) {
+  EnumCacheScope enum_scope;
+  out_buffer.clear();
+  out_bfbs_buffer.clear();
+  std::string bfbs_data, data;
+  if (!LoadSelectSources(bfbs_path, bin_path, bfbs_data, data)) return false;
+  auto schema = reflection::GetSchema(bfbs_data.c_str());
+  const uint8_t *buf = reinterpret_cast<const uint8_t *>(data.c_str());
+
+  SourceVector src;
+  if (!LocateSourceVector(schema, buf, top_level_vector_field, src)) return false;
+  std::vector<uint32_t> order;
+  OrderSourceVector(schema, src, sort, order);
+
+  // Only the surviving elements are turned into rows.
+  auto col_paths = SplitColumnPaths(columns);
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<selectresult::Row>> rows_off;
+  rows_off.reserve(order.size());
+  for (uint32_t idx : order) {
+    auto elem_ptr = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(src.vec, idx);
+    rows_off.push_back(CreateSelectRow(fbb, schema, src.child_obj, elem_ptr, col_paths));
+  }
+  FinishSelectResult(fbb, rows_off, out_buffer);
+  return LoadSelectResultBfbs(out_bfbs_buffer);
+}
+
+// FNV-1a over a byte range, continuing from `h`.
+static uint64_t Fnv1a(const void *bytes, size_t n, uint64_t h = 1469598103934665603ULL) {
+  auto p = static_cast<const unsigned char *>(bytes);
+  for (size_t i = 0; i < n; ++i) {
+    h ^= p[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// Ties a page cursor to the vector it was issued for: the vector's name plus
+// where the vector and its first and last elements sit in the buffer. Any
+// change to the data before or inside the vector shifts these, so a cursor
+// from another file or an edited copy is rejected, though two files laid out
+// byte-for-byte alike are indistinguishable.
+static uint64_t PageCursorTag(const uint8_t *data, const SourceVector &src) {
+  const std::string vec_name = src.field->name()->str();
+  uint64_t h = Fnv1a(vec_name.data(), vec_name.size());
+  size_t len = src.vec->size();
+  uint64_t where[3] = {static_cast<uint64_t>(reinterpret_cast<const uint8_t *>(src.vec) - data), 0, 0};
+  if (len) {
+    auto first = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(src.vec, 0);
+    auto last = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(src.vec, len - 1);
+    where[1] = static_cast<uint64_t>(reinterpret_cast<const uint8_t *>(first) - data);
+    where[2] = static_cast<uint64_t>(reinterpret_cast<const uint8_t *>(last) - data);
+  }
+  return Fnv1a(where, sizeof(where), h);
+}
+
+// Cursors are "p2:<next index>:<vector length>:<PageCursorTag>" in hex.
+// Callers should treat them as opaque.
+static std::string EncodePageCursor(size_t next_index, size_t len, uint64_t tag) {
+  std::ostringstream os;
+  os << "p2:" << std::hex << next_index << ':' << len << ':' << tag;
+  return os.str();
+}
+
+static bool DecodePageCursor(const std::string &cursor, size_t len, uint64_t tag, size_t &next_index) {
+  unsigned long long idx = 0, cur_len = 0, cur_tag = 0;
+  char tail = 0;
+  if (std::sscanf(cursor.c_str(), "p2:%llx:%llx:%llx%c", &idx, &cur_len, &cur_tag, &tail) != 3) return false;
+  if (cur_len != len || cur_tag != tag || idx > len) return false;
+  next_index = static_cast<size_t>(idx);
+  return true;
+}
+
+bool SelectColumnsForFlatbufferPage(const std::string &bfbs_data,
+                                    const uint8_t *data,
+                                    const std::string &top_level_vector_field,
+                                    const std::vector<std::string> &columns,
+                                    const SelectPage &page,
+                                    std::vector<uint8_t> &out_buffer,
+                                    std::vector<uint8_t> &out_bfbs_buffer,
+                                    std::string &next_cursor) {
+  EnumCacheScope enum_scope;
+  out_buffer.clear();
+  next_cursor.clear();
+  auto schema = reflection::GetSchema(bfbs_data.c_str());
+  if (!schema || !data) {
+    std::cerr << "SelectColumns: page needs a parsed schema and a data buffer\n";
+    return false;
+  }
+
+  SourceVector src;
+  if (!LocateSourceVector(schema, data, top_level_vector_field, src)) return false;
+  size_t len = src.vec->size();
+  const uint64_t tag = PageCursorTag(data, src);
+
+  size_t begin = std::min(page.offset, len);
+  if (!page.cursor.empty() && !DecodePageCursor(page.cursor, len, tag, begin)) {
+    std::cerr << "SelectColumns: page cursor does not belong to this vector or is stale\n";
+    return false;
+  }
+  size_t end = page.limit ? begin + std::min(page.limit, len - begin) : len;
+
+  // Vector elements are random access, so only the requested range is touched.
+  auto col_paths = SplitColumnPaths(columns);
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<selectresult::Row>> rows_off;
+  rows_off.reserve(end - begin);
+  for (size_t i = begin; i < end; ++i) {
+    auto elem_ptr = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(src.vec, i);
+    rows_off.push_back(CreateSelectRow(fbb, schema, src.child_obj, elem_ptr, col_paths));
+  }
+  FinishSelectResult(fbb, rows_off, out_buffer);
+  if (end < len) next_cursor = EncodePageCursor(end, len, tag);
+  // The result schema never changes, so a caller reusing out_bfbs_buffer
+  // across pages only pays for loading it once.
+  return !out_bfbs_buffer.empty() || LoadSelectResultBfbs(out_bfbs_buffer);
+}
+
+bool SelectColumnsForFlatbufferPage(const std::string &bfbs_path,
+                                    const std::string &bin_path,
+                                    const std::string &top_level_vector_field,
+                                    const std::vector<std::string> &columns,
+                                    const SelectPage &page,
+                                    std::vector<uint8_t> &out_buffer,
+                                    std::vector<uint8_t> &out_bfbs_buffer,
+                                    std::string &next_cursor) {
+  out_buffer.clear();
+  out_bfbs_buffer.clear();
+  next_cursor.clear();
+  std::string bfbs_data, data;
+  if (!LoadSelectSources(bfbs_path, bin_path, bfbs_data, data)) return false;
+  return SelectColumnsForFlatbufferPage(bfbs_data, reinterpret_cast<const uint8_t *>(data.c_str()),
+                                        top_level_vector_field, columns, page, out_buffer,
+                                        out_bfbs_buffer, next_cursor);
+}
+
+// Resolve the leaf field of a (possibly nested) path using schema metadata
+// only. Intermediate segments must be object-valued.
+static const reflection::Field *ResolvePathField(const reflection::Schema *schema,
+                                                 const reflection::Object *obj,
+                                                 const std::vector<std::string> &path) {
+  for (size_t i = 0; i < path.size(); ++i) {
+    auto f = FindFieldByName(obj, path[i]);
+    if (!f) return nullptr;
+    if (i + 1 == path.size()) return f;
+    if (f->type()->base_type() != reflection::Obj) return nullptr;
+    int type_index = f->type()->index();
+    if (type_index < 0 || !schema->objects() || type_index >= schema->objects()->size()) return nullptr;
+    obj = schema->objects()->Get(type_index);
+  }
+  return nullptr;
+}
+
+// Look up an enum value by name for an integer field, if the field is an enum.
+static bool FindEnumValueByName(const reflection::Schema *schema, const reflection::Field *field,
+                                const std::string &name, int64_t &out) {
+  int idx = field->type()->index();
+  if (idx < 0 || !schema->enums() || idx >= schema->enums()->size()) return false;
+  auto e = schema->enums()->Get(idx);
+  if (!e || !e->values()) return false;
+  for (auto vit = e->values()->begin(); vit != e->values()->end(); ++vit) {
+    auto vv = *vit;
+    if (vv && vv->name() && vv->name()->str() == name) {
+      out = vv->value();
+      return true;
     }
+  }
+  return false;
+}
+
+// Parse a filter literal into a ColumnValue of the field's kind.
+static bool ParseFilterValue(const reflection::Schema *schema, const reflection::Field *field,
+                             const std::string &text, ColumnValue &out) {
+  out = ColumnValue();
+  const char *begin = text.c_str();
+  char *end = nullptr;
+  switch (field->type()->base_type()) {
+    case reflection::String:
+      out.kind = ColumnValue::Str;
+      out.s = text;
+      return true;
+    case reflection::ULong:
+      out.kind = ColumnValue::UInt;
+      out.u = std::strtoull(begin, &end, 10);
+      return !text.empty() && *end == '\0';
+    case reflection::Bool:
+      if (text == "true" || text == "false") {
+        out.kind = ColumnValue::Int;
+        out.i = text == "true" ? 1 : 0;
+        return true;
+      }
+      [[fallthrough]];  // also accept 0/1
+    case reflection::Byte:
+    case reflection::UByte:
+    case reflection::Short:
+    case reflection::UShort:
+    case reflection::Int:
+    case reflection::UInt:
+    case reflection::Long:
+      out.kind = ColumnValue::Int;
+      out.i = std::strtoll(begin, &end, 10);
+      if (!text.empty() && *end == '\0') return true;
+      return FindEnumValueByName(schema, field, text, out.i);
+    case reflection::Float:
+    case reflection::Double:
+      out.kind = ColumnValue::Float;
+      out.f = std::strtod(begin, &end);
+      return !text.empty() && *end == '\0';
+    default:
+      return false;
+  }
+}
+
+// Three-way compare of two non-null values of the same kind.
+static int CompareColumnValues(const ColumnValue &a, const ColumnValue &b) {
+  switch (a.kind) {
+    case ColumnValue::Int: return a.i < b.i ? -1 : (a.i > b.i ? 1 : 0);
+    case ColumnValue::UInt: return a.u < b.u ? -1 : (a.u > b.u ? 1 : 0);
+    case ColumnValue::Float: return a.f < b.f ? -1 : (a.f > b.f ? 1 : 0);
+    case ColumnValue::Str: return a.s.compare(b.s) < 0 ? -1 : (a.s == b.s ? 0 : 1);
+    default: return 0;
+  }
+}
+
+static bool FilterMatches(SelectFilterOp op, const ColumnValue &v, const ColumnValue &literal) {
+  if (v.kind == ColumnValue::Null || v.kind != literal.kind) return false;
+  // NaN is unordered, so like a missing value it satisfies no filter.
+  if (IsNaN(v) || IsNaN(literal)) return false;
+  int c = CompareColumnValues(v, literal);
+  switch (op) {
+    case SelectFilterOp::Eq: return c == 0;
+    case SelectFilterOp::Ne: return c != 0;
+    case SelectFilterOp::Lt: return c < 0;
+    case SelectFilterOp::Le: return c <= 0;
+    case SelectFilterOp::Gt: return c > 0;
+    case SelectFilterOp::Ge: return c >= 0;
+  }
+  return false;
+}
+
+// A filter resolved against a column slot of a shared scan.
+struct CompiledFilter {
+  size_t slot;
+  const reflection::Field *field;
+  SelectFilterOp op;
+  std::string literal_text;  // owns the bytes a string literal points at
+  ColumnValue literal;
+};
+
+// Per-element cache of the distinct columns read by a shared scan. Slots are
+// read lazily, so output columns are skipped for elements no query keeps.
+struct ColumnSlots {
+  std::vector<std::vector<std::string>> paths;
+  std::vector<ColumnValue> values;
+  std::vector<const reflection::Field *> fields;
+  std::vector<char> loaded;
+
+  size_t Intern(const std::string &column, std::unordered_map<std::string, size_t> &index) {
+    auto it = index.find(column);
+    if (it != index.end()) return it->second;
+    size_t slot = paths.size();
+    index.emplace(column, slot);
+    paths.push_back(SplitPath(column));
+    values.emplace_back();
+    fields.push_back(nullptr);
+    loaded.push_back(0);
+    return slot;
+  }
+
+  void Reset() { std::fill(loaded.begin(), loaded.end(), 0); }
+
+  const ColumnValue &Get(const reflection::Schema *schema, const reflection::Object *obj,
+                         const flatbuffers::Table *elem, size_t slot) {
+    if (!loaded[slot]) {
+      fields[slot] = ReadColumnValue(schema, obj, elem, paths[slot], values[slot]);
+      loaded[slot] = 1;
+    }
+    return values[slot];
+  }
+};
+
+// Run queries against an already-loaded binary, one pass per distinct vector.
+// Shared by the batch and filtered multi-file entry points.
+static bool SelectQueriesFromBuffer(const reflection::Schema *schema,
+                                    const uint8_t *buf,
+                                    const std::vector<SelectQuery> &queries,
+                                    std::vector<std::vector<uint8_t>> &out_buffers) {
+  EnumCacheScope enum_scope;
+  out_buffers.assign(queries.size(), std::vector<uint8_t>());
+  // Resolve every query's vector, then group queries scanning the same one.
+  std::vector<SourceVector> sources(queries.size());
+  std::vector<std::vector<size_t>> groups;
+  std::unordered_map<const flatbuffers::VectorOfAny *, size_t> group_of_vec;
+  for (size_t q = 0; q < queries.size(); ++q) {
+    if (!LocateSourceVector(schema, buf, queries[q].top_level_vector_field, sources[q])) return false;
+    auto it = group_of_vec.find(sources[q].vec);
+    if (it == group_of_vec.end()) {
+      group_of_vec.emplace(sources[q].vec, groups.size());
+      groups.push_back({q});
+    } else {
+      groups[it->second].push_back(q);
+    }
+  }
+
+  for (const auto &group : groups) {
+    const SourceVector &src = sources[group.front()];
+    ColumnSlots slots;
+    std::unordered_map<std::string, size_t> slot_index;
+    std::vector<std::vector<size_t>> query_cols(group.size());
+    std::vector<std::vector<CompiledFilter>> query_filters(group.size());
+    for (size_t g = 0; g < group.size(); ++g) {
+      const SelectQuery &query = queries[group[g]];
+      for (const auto &c : query.columns) query_cols[g].push_back(slots.Intern(c, slot_index));
+      for (const auto &f : query.filters) {
+        const reflection::Field *field = ResolvePathField(schema, src.child_obj, SplitPath(f.column));
+        if (!field) {
+          std::cerr << "SelectColumns: filter column '" << f.column << "' not found\n";
+          return false;
+        }
+        CompiledFilter cf;
+        cf.slot = slots.Intern(f.column, slot_index);
+        cf.field = field;
+        cf.op = f.op;
+        cf.literal_text = f.value;
+        query_filters[g].push_back(std::move(cf));
+      }
+    }
+    // Parse literals once the filter vectors stop moving, so string literals
+    // can point at their owned text.
+    for (size_t g = 0; g < group.size(); ++g) {
+      for (size_t fi = 0; fi < query_filters[g].size(); ++fi) {
+        auto &cf = query_filters[g][fi];
+        if (!ParseFilterValue(schema, cf.field, cf.literal_text, cf.literal)) {
+          std::cerr << "SelectColumns: cannot compare column '" << queries[group[g]].filters[fi].column
+                    << "' with '" << cf.literal_text << "'\n";
+          return false;
+        }
+      }
+    }
+
+    std::vector<flatbuffers::FlatBufferBuilder> builders(group.size());
+    std::vector<std::vector<flatbuffers::Offset<selectresult::Row>>> rows(group.size());
     std::vector<flatbuffers::Offset<flatbuffers::String>> col_strs;
-    col_strs.reserve(columns.size());
-    for (size_t ci = 0; ci < col_paths.size(); ++ci) {
-      const auto &path = col_paths[ci];
-      const flatbuffers::Table *value_table = nullptr;
-      const reflection::Field *field = ResolveNestedField(schema, child_obj, elem_ptr, path, value_table);
-      if (!field || !value_table) { col_strs.push_back(fbb.CreateString(std::string(""))); continue; }
-      auto btype = field->type()->base_type();
-      switch (btype) {
-        case reflection::String: {
-          auto s = flatbuffers::GetFieldS(*value_table, *field);
-          col_strs.push_back(s ? fbb.CreateString(s->str()) : 0);
-          break;
+    size_t len = src.vec->size();
+    for (size_t i = 0; i < len; ++i) {
+      auto elem = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(src.vec, i);
+      slots.Reset();
+      for (size_t g = 0; g < group.size(); ++g) {
+        bool keep = true;
+        for (const auto &cf : query_filters[g]) {
+          if (!FilterMatches(cf.op, slots.Get(schema, src.child_obj, elem, cf.slot), cf.literal)) {
+            keep = false;
+            break;
+          }
         }
-        case reflection::Bool:
-        case reflection::Byte:
-        case reflection::UByte:
-        case reflection::Short:
-        case reflection::UShort:
-        case reflection::Int:
-        case reflection::UInt:
-        case reflection::Long:
-        case reflection::ULong: {
-          int64_t v = flatbuffers::GetAnyFieldI(*value_table, *field);
-          const char *ename = FindEnumNameForField(schema, field, v);
-          if (ename) col_strs.push_back(fbb.CreateString(std::string(ename)));
-          else col_strs.push_back(fbb.CreateString(std::to_string(v)));
-          break;
+        if (!keep) continue;
+        auto &fbb = builders[g];
+        col_strs.clear();
+        if (elem) {
+          for (size_t slot : query_cols[g]) {
+            const ColumnValue &v = slots.Get(schema, src.child_obj, elem, slot);
+            col_strs.push_back(CreateCell(fbb, schema, slots.fields[slot], v));
+          }
         }
-        case reflection::Float:
-        case reflection::Double: {
-          double dv = flatbuffers::GetAnyFieldF(*value_table, *field);
-          col_strs.push_back(fbb.CreateString(std::to_string(dv)));
-          break;
+        rows[g].push_back(selectresult::CreateRow(fbb, fbb.CreateVector(col_strs)));
+      }
+    }
+    for (size_t g = 0; g < group.size(); ++g) FinishSelectResult(builders[g], rows[g], out_buffers[group[g]]);
+  }
+  return true;
+}
+
+// Rows of one join input: the elements of a vector-of-objects, or the root
+// table alone when `root_as_row` is set. Owns the loaded schema and data.
+struct JoinInput {
+  std::string bfbs_data;
+  std::string data;
+  const reflection::Schema *schema = nullptr;
+  const reflection::Object *obj = nullptr;
+  const flatbuffers::VectorOfAny *vec = nullptr;
+  const flatbuffers::Table *root = nullptr;
+
+  size_t Size() const { return vec ? vec->size() : 1; }
+  const flatbuffers::Table *Row(size_t i) const {
+    return vec ? flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(vec, i) : root;
+  }
+};
+
+static bool LoadJoinInput(const JoinSide &side, JoinInput &in) {
+  if (!LoadSelectSources(side.bfbs_path, side.bin_path, in.bfbs_data, in.data)) return false;
+  in.schema = reflection::GetSchema(in.bfbs_data.c_str());
+  const uint8_t *buf = reinterpret_cast<const uint8_t *>(in.data.c_str());
+  if (side.root_as_row) {
+    in.root = flatbuffers::GetAnyRoot(buf);
+    in.obj = in.schema->root_table();
+    if (!in.obj) {
+      std::cerr << "HashJoin: schema has no root table: " << side.bfbs_path << "\n";
+      return false;
+    }
+    return true;
+  }
+  SourceVector src;
+  if (!LocateSourceVector(in.schema, buf, side.vector_field, src)) return false;
+  in.vec = src.vec;
+  in.obj = src.child_obj;
+  return true;
+}
+
+// Join key normalized so equal numbers compare equal regardless of their
+// schema width or signedness; strings point into the loaded buffers.
+struct JoinKey {
+  ColumnValue::Kind kind = ColumnValue::Null;
+  uint64_t bits = 0;
+  std::string_view s;
+
+  bool operator==(const JoinKey &o) const { return kind == o.kind && bits == o.bits && s == o.s; }
+};
+
+struct JoinKeyHash {
+  size_t operator()(const JoinKey &k) const {
+    if (k.kind == ColumnValue::Str) return std::hash<std::string_view>()(k.s);
+    return std::hash<uint64_t>()(k.bits) ^ static_cast<size_t>(k.kind);
+  }
+};
+
+static JoinKey MakeJoinKey(const ColumnValue &v) {
+  JoinKey k;
+  k.kind = v.kind;
+  switch (v.kind) {
+    case ColumnValue::Int:
+      k.bits = static_cast<uint64_t>(v.i);
+      break;
+    case ColumnValue::UInt:
+      // Values that fit in int64 share the Int representation.
+      k.bits = v.u;
+      if (v.u <= static_cast<uint64_t>(INT64_MAX)) k.kind = ColumnValue::Int;
+      break;
+    case ColumnValue::Float:
+      // Integral values take the key an integer of the same value would get;
+      // every double in [2^63, 2^64) is integral and matches a large ulong.
+      // Callers skip NaN, which never equals anything.
+      if (v.f >= -9223372036854775808.0 && v.f < 9223372036854775808.0 &&
+          v.f == static_cast<double>(static_cast<int64_t>(v.f))) {
+        k.kind = ColumnValue::Int;
+        k.bits = static_cast<uint64_t>(static_cast<int64_t>(v.f));
+      } else if (v.f >= 9223372036854775808.0 && v.f < 18446744073709551616.0) {
+        k.kind = ColumnValue::UInt;
+        k.bits = static_cast<uint64_t>(v.f);
+      } else {
+        std::memcpy(&k.bits, &v.f, sizeof(k.bits));
+      }
+      break;
+    case ColumnValue::Str:
+      k.s = v.s;
+      break;
+    default:
+      break;
+  }
+  return k;
+}
+
+bool HashJoinFlatbuffers(const JoinSide &left,
+                         const JoinSide &right,
+                         std::vector<uint8_t> &out_buffer,
+                         std::vector<uint8_t> &out_bfbs_buffer) {
+  EnumCacheScope enum_scope;
+  out_buffer.clear();
+  out_bfbs_buffer.clear();
+  JoinInput in[2];
+  const JoinSide *sides[2] = {&left, &right};
+  std::vector<std::string> key_path[2];
+  std::vector<std::vector<std::string>> col_paths[2];
+  bool key_is_string[2];
+  for (int s = 0; s < 2; ++s) {
+    if (!LoadJoinInput(*sides[s], in[s])) return false;
+    key_path[s] = SplitPath(sides[s]->key_column);
+    col_paths[s] = SplitColumnPaths(sides[s]->columns);
+    auto key_field = ResolvePathField(in[s].schema, in[s].obj, key_path[s]);
+    if (!key_field) {
+      std::cerr << "HashJoin: key column '" << sides[s]->key_column << "' not found\n";
+      return false;
+    }
+    // Tables, vectors and unions have no single comparable value.
+    auto bt = key_field->type()->base_type();
+    if (bt != reflection::String && !flatbuffers::IsScalar(bt)) {
+      std::cerr << "HashJoin: key column '" << sides[s]->key_column << "' must be a scalar or string\n";
+      return false;
+    }
+    key_is_string[s] = bt == reflection::String;
+  }
+  if (key_is_string[0] != key_is_string[1]) {
+    std::cerr << "HashJoin: cannot join a string key with a numeric key\n";
+    return false;
+  }
+
+  // Build on the smaller side; stream the other one through the table.
+  int b = in[0].Size() <= in[1].Size() ? 0 : 1;
+  int p = 1 - b;
+  const JoinInput &build = in[b];
+  const JoinInput &probe = in[p];
+
+  // Key -> first matching build row; `next_match` chains further rows with
+  // the same key, so the table holds one index per build row.
+  const uint32_t kNoRow = UINT32_MAX;
+  size_t build_len = build.Size();
+  std::unordered_map<JoinKey, uint32_t, JoinKeyHash> head;
+  head.reserve(build_len);
+  std::vector<uint32_t> next_match(build_len, kNoRow);
+  ColumnValue v;
+  // Insert in reverse so each chain lists build rows in vector order.
+  for (size_t i = build_len; i-- > 0;) {
+    ReadColumnValue(build.schema, build.obj, build.Row(i), key_path[b], v);
+    if (v.kind == ColumnValue::Null || IsNaN(v)) continue;
+    auto res = head.emplace(MakeJoinKey(v), static_cast<uint32_t>(i));
+    if (!res.second) {
+      next_match[i] = res.first->second;
+      res.first->second = static_cast<uint32_t>(i);
+    }
+  }
+
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<selectresult::Row>> rows_off;
+  std::vector<flatbuffers::Offset<flatbuffers::String>> col_strs;
+  const flatbuffers::Table *row_tables[2];
+  for (size_t i = 0; i < probe.Size(); ++i) {
+    row_tables[p] = probe.Row(i);
+    ReadColumnValue(probe.schema, probe.obj, row_tables[p], key_path[p], v);
+    if (v.kind == ColumnValue::Null || IsNaN(v)) continue;
+    auto it = head.find(MakeJoinKey(v));
+    if (it == head.end()) continue;
+    for (uint32_t m = it->second; m != kNoRow; m = next_match[m]) {
+      row_tables[b] = build.Row(m);
+      // Output columns are always left side first, then right side.
+      col_strs.clear();
+      for (int s = 0; s < 2; ++s) {
+        for (const auto &path : col_paths[s]) {
+          ColumnValue cell;
+          const reflection::Field *field = ReadColumnValue(in[s].schema, in[s].obj, row_tables[s], path, cell);
+          col_strs.push_back(CreateCell(fbb, in[s].schema, field, cell));
         }
-        default:
-          col_strs.push_back(fbb.CreateString(std::string("")));
       }
+      rows_off.push_back(selectresult::CreateRow(fbb, fbb.CreateVector(col_strs)));
     }
-    auto vec_off = fbb.CreateVector(col_strs);
-    rows_off.push_back(selectresult::CreateRow(fbb, vec_off));
   }
+  FinishSelectResult(fbb, rows_off, out_buffer);
+  return LoadSelectResultBfbs(out_bfbs_buffer);
+}
 
-  auto rows_vec = fbb.CreateVector(rows_off);
-  auto root = selectresult::CreateResult(fbb, rows_vec);
-  fbb.Finish(root);
+std::string ShardStatsPath(const std::string &bin_path) {
+  return bin_path + ".stats";
+}
 
-  // return buffer bytes and the generated bfbs bytes so callers can introspect in-memory
-  out_buffer.assign(fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
-  // load the generated bfbs for the select_result schema into the out buffer
-  std::string gen_bfbs;
-  if (!flatbuffers::LoadFile("reflection/select_result.bfbs", true, &gen_bfbs)) {
-    std::cerr << "SelectColumns: failed to load generated select_result.bfbs\n";
+// Running min/max/null-count for one stats path.
+struct PathStats {
+  ColumnValue min, max;
+  std::string min_s, max_s;  // owned copies for string columns
+  uint64_t null_count = 0;
+  uint64_t row_count = 0;
+
+  void Add(const ColumnValue &v) {
+    ++row_count;
+    if (v.kind == ColumnValue::Null) {
+      ++null_count;
+      return;
+    }
+    // NaN would compare equal to everything and pin min/max; it matches no
+    // filter, so leaving it out keeps the range exact for the rows that can.
+    if (IsNaN(v)) return;
+    if (min.kind == ColumnValue::Null || CompareColumnValues(v, min) < 0) {
+      min = v;
+      if (v.kind == ColumnValue::Str) min_s.assign(v.s.data(), v.s.size());
+    }
+    if (max.kind == ColumnValue::Null || CompareColumnValues(v, max) > 0) {
+      max = v;
+      if (v.kind == ColumnValue::Str) max_s.assign(v.s.data(), v.s.size());
+    }
+  }
+};
+
+// Resolve the scalar/string leaf of a stats path that leads through tables or
+// vectors of tables; nullptr if the path is not such a path.
+static const reflection::Field *StatsPathLeaf(const reflection::Schema *schema, const reflection::Object *obj,
+                                              const std::vector<std::string> &path) {
+  for (size_t i = 0; i < path.size(); ++i) {
+    auto f = FindFieldByName(obj, path[i]);
+    if (!f) return nullptr;
+    auto bt = f->type()->base_type();
+    if (i + 1 == path.size()) return bt == reflection::String || flatbuffers::IsScalar(bt) ? f : nullptr;
+    bool nested = bt == reflection::Obj || (bt == reflection::Vector && f->type()->element() == reflection::Obj);
+    int type_index = f->type()->index();
+    if (!nested || type_index < 0 || !schema->objects() || type_index >= schema->objects()->size()) return nullptr;
+    obj = schema->objects()->Get(type_index);
+  }
+  return nullptr;
+}
+
+// Check that a stats path leads through tables or vectors of tables to a
+// scalar/string leaf.
+static bool ValidateStatsPath(const reflection::Schema *schema, const reflection::Object *obj,
+                              const std::vector<std::string> &path) {
+  return StatsPathLeaf(schema, obj, path) != nullptr;
+}
+
+// Accumulate the leaf values of a validated path. Vectors of tables fan out
+// into one row per element; a missing table along the way counts as a null.
+static void CollectPathStats(const reflection::Schema *schema, const reflection::Object *obj,
+                             const flatbuffers::Table *table, const std::vector<std::string> &path,
+                             size_t pos, PathStats &stats) {
+  if (!table) {
+    stats.Add(ColumnValue());
+    return;
+  }
+  auto f = FindFieldByName(obj, path[pos]);
+  if (pos + 1 == path.size()) {
+    ColumnValue v;
+    ReadFieldValue(*table, *f, v);
+    stats.Add(v);
+    return;
+  }
+  auto child_obj = schema->objects()->Get(f->type()->index());
+  if (f->type()->base_type() == reflection::Obj) {
+    CollectPathStats(schema, child_obj, flatbuffers::GetFieldT(*table, *f), path, pos + 1, stats);
+    return;
+  }
+  auto vec = flatbuffers::GetFieldAnyV(*table, *f);
+  if (!vec) {
+    stats.Add(ColumnValue());
+    return;
+  }
+  for (size_t i = 0; i < vec->size(); ++i) {
+    auto elem = flatbuffers::GetAnyVectorElemPointer<const flatbuffers::Table>(vec, i);
+    CollectPathStats(schema, child_obj, elem, path, pos + 1, stats);
+  }
+}
+
+// Last write time of a file in file_clock ticks; sidecars record it next to
+// the size so any rewrite, even one that keeps the size, invalidates them.
+static bool SourceWriteTime(const std::string &path, int64_t &ticks) {
+  std::error_code ec;
+  auto t = std::filesystem::last_write_time(path, ec);
+  if (ec) return false;
+  ticks = static_cast<int64_t>(t.time_since_epoch().count());
+  return true;
+}
+
+bool WriteShardStats(const std::string &bfbs_path,
+                     const std::string &bin_path,
+                     const std::vector<std::string> &paths,
+                     const std::string &stats_path) {
+  // Taken before loading: a rewrite during the scan leaves the sidecar stale
+  // rather than describing the old contents under the new timestamp.
+  int64_t source_mtime = 0;
+  if (!SourceWriteTime(bin_path, source_mtime)) {
+    std::cerr << "ShardStats: cannot stat " << bin_path << "\n";
     return false;
   }
-  out_bfbs_buffer.assign(reinterpret_cast<const uint8_t*>(gen_bfbs.c_str()), reinterpret_cast<const uint8_t*>(gen_bfbs.c_str()) + gen_bfbs.size());
+  std::string bfbs_data, data;
+  if (!LoadSelectSources(bfbs_path, bin_path, bfbs_data, data)) return false;
+  auto schema = reflection::GetSchema(bfbs_data.c_str());
+  auto root_obj = schema->root_table();
+  auto root_table = flatbuffers::GetAnyRoot(reinterpret_cast<const uint8_t *>(data.c_str()));
+
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<shardstats::ColumnStats>> cols;
+  for (const auto &p : paths) {
+    auto path = SplitPath(p);
+    if (path.empty() || !ValidateStatsPath(schema, root_obj, path)) {
+      std::cerr << "ShardStats: path '" << p << "' does not lead to a scalar or string field\n";
+      return false;
+    }
+    PathStats st;
+    CollectPathStats(schema, root_obj, root_table, path, 0, st);
+
+    auto path_off = fbb.CreateString(p);
+    flatbuffers::Offset<flatbuffers::String> min_s, max_s;
+    if (st.min.kind == ColumnValue::Str) {
+      min_s = fbb.CreateString(st.min_s);
+      max_s = fbb.CreateString(st.max_s);
+    }
+    shardstats::ColumnStatsBuilder cb(fbb);
+    cb.add_path(path_off);
+    cb.add_null_count(st.null_count);
+    cb.add_row_count(st.row_count);
+    switch (st.min.kind) {
+      case ColumnValue::Int:
+        cb.add_kind(shardstats::StatsKind_Int);
+        cb.add_min_i(st.min.i);
+        cb.add_max_i(st.max.i);
+        break;
+      case ColumnValue::UInt:
+        cb.add_kind(shardstats::StatsKind_UInt);
+        cb.add_min_u(st.min.u);
+        cb.add_max_u(st.max.u);
+        break;
+      case ColumnValue::Float:
+        cb.add_kind(shardstats::StatsKind_Float);
+        cb.add_min_f(st.min.f);
+        cb.add_max_f(st.max.f);
+        break;
+      case ColumnValue::Str:
+        cb.add_kind(shardstats::StatsKind_String);
+        cb.add_min_s(min_s);
+        cb.add_max_s(max_s);
+        break;
+      default:
+        cb.add_kind(shardstats::StatsKind_Empty);
+    }
+    cols.push_back(cb.Finish());
+  }
+  auto cols_vec = fbb.CreateVector(cols);
+  shardstats::ShardStatsBuilder sb(fbb);
+  sb.add_source_size(data.size());
+  sb.add_source_mtime(source_mtime);
+  sb.add_columns(cols_vec);
+  fbb.Finish(sb.Finish());
+
+  const std::string out_path = stats_path.empty() ? ShardStatsPath(bin_path) : stats_path;
+  if (!flatbuffers::SaveFile(out_path.c_str(), reinterpret_cast<const char *>(fbb.GetBufferPointer()), fbb.GetSize(), true)) {
+    std::cerr << "ShardStats: failed to write " << out_path << "\n";
+    return false;
+  }
+  return true;
+}
+
+// Parse a filter literal into the kind recorded by the stats. Returns false
+// when the literal cannot be compared (e.g. an enum name), in which case the
+// caller must assume the shard may match.
+static bool ParseStatsLiteral(shardstats::StatsKind kind, const std::string &text, ColumnValue &out) {
+  out = ColumnValue();
+  const char *begin = text.c_str();
+  char *end = nullptr;
+  if (text.empty() && kind != shardstats::StatsKind_String) return false;
+  switch (kind) {
+    case shardstats::StatsKind_Int:
+      out.kind = ColumnValue::Int;
+      if (text == "true" || text == "false") {
+        out.i = text == "true" ? 1 : 0;
+        return true;
+      }
+      out.i = std::strtoll(begin, &end, 10);
+      return *end == '\0';
+    case shardstats::StatsKind_UInt:
+      out.kind = ColumnValue::UInt;
+      out.u = std::strtoull(begin, &end, 10);
+      return *end == '\0';
+    case shardstats::StatsKind_Float:
+      out.kind = ColumnValue::Float;
+      out.f = std::strtod(begin, &end);
+      return *end == '\0';
+    case shardstats::StatsKind_String:
+      out.kind = ColumnValue::Str;
+      out.s = text;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// True unless [min, max] proves no non-null value satisfies `op literal`.
+static bool RangeMayMatch(SelectFilterOp op, const ColumnValue &min, const ColumnValue &max,
+                          const ColumnValue &literal) {
+  int lo = CompareColumnValues(min, literal);
+  int hi = CompareColumnValues(max, literal);
+  switch (op) {
+    case SelectFilterOp::Eq: return lo <= 0 && hi >= 0;
+    case SelectFilterOp::Ne: return !(lo == 0 && hi == 0);
+    case SelectFilterOp::Lt: return lo < 0;
+    case SelectFilterOp::Le: return lo <= 0;
+    case SelectFilterOp::Gt: return hi > 0;
+    case SelectFilterOp::Ge: return hi >= 0;
+  }
+  return true;
+}
+
+// Load the stats sidecar of `bin_path` into `stats_data`. Returns nullptr when
+// it is missing, unreadable or was computed for a different version of the
+// binary, since such stats prove nothing.
+static const shardstats::ShardStats *LoadFreshShardStats(const std::string &bin_path, std::string &stats_data) {
+  if (!flatbuffers::LoadFile(ShardStatsPath(bin_path).c_str(), true, &stats_data)) return nullptr;
+  flatbuffers::Verifier verifier(reinterpret_cast<const uint8_t *>(stats_data.data()), stats_data.size());
+  if (!shardstats::VerifyShardStatsBuffer(verifier)) return nullptr;
+  auto stats = shardstats::GetShardStats(stats_data.data());
+  if (!stats->columns()) return nullptr;
+
+  std::error_code ec;
+  auto bin_size = std::filesystem::file_size(bin_path, ec);
+  if (ec || bin_size != stats->source_size()) return nullptr;
+  int64_t bin_mtime = 0;
+  if (!SourceWriteTime(bin_path, bin_mtime) || bin_mtime != stats->source_mtime()) return nullptr;
+  return stats;
+}
+
+// False only when `stats` prove that no row satisfies every filter.
+static bool StatsMayMatch(const shardstats::ShardStats *stats, const std::vector<SelectFilter> &filters) {
+  for (const auto &f : filters) {
+    const shardstats::ColumnStats *col = nullptr;
+    for (auto c : *stats->columns()) {
+      if (c->path() && c->path()->str() == f.column) {
+        col = c;
+        break;
+      }
+    }
+    if (!col) continue;
+    // Nulls never satisfy a filter.
+    if (col->null_count() == col->row_count() || col->kind() == shardstats::StatsKind_Empty) return false;
+    ColumnValue literal;
+    if (!ParseStatsLiteral(col->kind(), f.value, literal)) continue;
+    ColumnValue min, max;
+    min.kind = max.kind = literal.kind;
+    switch (col->kind()) {
+      case shardstats::StatsKind_Int: min.i = col->min_i(); max.i = col->max_i(); break;
+      case shardstats::StatsKind_UInt: min.u = col->min_u(); max.u = col->max_u(); break;
+      case shardstats::StatsKind_Float: min.f = col->min_f(); max.f = col->max_f(); break;
+      case shardstats::StatsKind_String:
+        if (!col->min_s() || !col->max_s()) continue;
+        min.s = std::string_view(col->min_s()->c_str(), col->min_s()->size());
+        max.s = std::string_view(col->max_s()->c_str(), col->max_s()->size());
+        break;
+      default: continue;
+    }
+    if (!RangeMayMatch(f.op, min, max, literal)) return false;
+  }
+  return true;
+}
+
+bool ShardMayMatch(const std::string &bin_path, const std::vector<SelectFilter> &filters) {
+  if (filters.empty()) return true;
+  std::string stats_data;
+  const shardstats::ShardStats *stats = LoadFreshShardStats(bin_path, stats_data);
+  return !stats || StatsMayMatch(stats, filters);
+}
+
+// Map element-relative select filters onto the root-relative paths shard
+// stats use ("age" on persons becomes "persons.age").
+static bool ShardFiltersForVector(const reflection::Schema *schema,
+                                  const std::string &top_level_vector_field,
+                                  const std::vector<SelectFilter> &filters,
+                                  std::vector<SelectFilter> &shard_filters) {
+  shard_filters.clear();
+  auto root_obj = schema->root_table();
+  const reflection::Field *vec_field = root_obj ? FindTopLevelVectorField(root_obj, top_level_vector_field) : nullptr;
+  if (!vec_field) return false;
+  for (const auto &f : filters) {
+    shard_filters.push_back(f);
+    shard_filters.back().column = vec_field->name()->str() + "." + f.column;
+  }
   return true;
 }
 
+// Check root-relative shard filters against the schema: each path must be a
+// valid stats path and each literal must parse as the leaf's type.
+static bool ValidateShardFilters(const reflection::Schema *schema, const std::vector<SelectFilter> &shard_filters) {
+  for (const auto &f : shard_filters) {
+    const reflection::Field *leaf = schema->root_table() ? StatsPathLeaf(schema, schema->root_table(), SplitPath(f.column))
+                                                          : nullptr;
+    if (!leaf) {
+      std::cerr << "ShardStats: path '" << f.column << "' does not lead to a scalar or string field\n";
+      return false;
+    }
+    ColumnValue literal;
+    if (!ParseFilterValue(schema, leaf, f.value, literal)) {
+      std::cerr << "ShardStats: cannot compare '" << f.column << "' with '" << f.value << "'\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Check every query's filter columns and literals against the schema alone,
+// so a bad filter is reported whether or not the binary ends up being read.
+static bool ValidateQueryFilters(const reflection::Schema *schema, const std::vector<SelectQuery> &queries) {
+  auto root_obj = schema->root_table();
+  if (!root_obj || !root_obj->fields()) {
+    std::cerr << "SelectColumns: root_obj or fields missing\n";
+    return false;
+  }
+  for (const auto &q : queries) {
+    if (q.filters.empty()) continue;
+    const reflection::Field *vec_field = FindTopLevelVectorField(root_obj, q.top_level_vector_field);
+    if (!vec_field) return false;
+    const reflection::Object *child_obj = VectorElementObject(schema, vec_field);
+    if (!child_obj) {
+      std::cerr << "SelectColumns: failed to resolve child object type for vector elements\n";
+      return false;
+    }
+    for (const auto &f : q.filters) {
+      const reflection::Field *field = ResolvePathField(schema, child_obj, SplitPath(f.column));
+      if (!field) {
+        std::cerr << "SelectColumns: filter column '" << f.column << "' not found\n";
+        return false;
+      }
+      ColumnValue literal;
+      if (!ParseFilterValue(schema, field, f.value, literal)) {
+        std::cerr << "SelectColumns: cannot compare column '" << f.column << "' with '" << f.value << "'\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// True when the shard stats rule out the whole binary: either the
+// root-relative `shard_filters` cannot match, or every query has filters and
+// none of them can. The sidecar is read once for the whole batch.
+static bool BatchPrunedByStats(const reflection::Schema *schema,
+                               const std::string &bin_path,
+                               const std::vector<SelectQuery> &queries,
+                               const std::vector<SelectFilter> &shard_filters) {
+  bool queries_filtered = !queries.empty();
+  for (const auto &q : queries) {
+    if (q.filters.empty()) queries_filtered = false;
+  }
+  if (!queries_filtered && shard_filters.empty()) return false;
+  std::string stats_data;
+  const shardstats::ShardStats *stats = LoadFreshShardStats(bin_path, stats_data);
+  if (!stats) return false;
+  if (!shard_filters.empty() && !StatsMayMatch(stats, shard_filters)) return true;
+  if (!queries_filtered) return false;
+  std::vector<SelectFilter> query_shard_filters;
+  for (const auto &q : queries) {
+    if (!ShardFiltersForVector(schema, q.top_level_vector_field, q.filters, query_shard_filters)) return false;
+    if (StatsMayMatch(stats, query_shard_filters)) return false;
+  }
+  return true;
+}
+
+bool SelectColumnsForFlatbufferBatch(const std::string &bfbs_path,
+                                     const std::string &bin_path,
+                                     const std::vector<SelectQuery> &queries,
+                                     std::vector<std::vector<uint8_t>> &out_buffers,
+                                     std::vector<uint8_t> &out_bfbs_buffer,
+                                     const std::vector<SelectFilter> &shard_filters) {
+  out_buffers.assign(queries.size(), std::vector<uint8_t>());
+  out_bfbs_buffer.clear();
+  std::string bfbs_data, data;
+  if (!LoadSelectSchema(bfbs_path, bfbs_data)) return false;
+  auto schema = reflection::GetSchema(bfbs_data.c_str());
+  if (!ValidateQueryFilters(schema, queries) || !ValidateShardFilters(schema, shard_filters)) return false;
+  // Skip the binary entirely when its stats sidecar rules it out.
+  if (BatchPrunedByStats(schema, bin_path, queries, shard_filters)) {
+    for (auto &out : out_buffers) EmptySelectResult(out);
+    return LoadSelectResultBfbs(out_bfbs_buffer);
+  }
+  if (!flatbuffers::LoadFile(bin_path.c_str(), true, &data)) {
+    std::cerr << "SelectColumns: failed to load bin: " << bin_path << "\n";
+    return false;
+  }
+  const uint8_t *buf = reinterpret_cast<const uint8_t *>(data.c_str());
+  if (!SelectQueriesFromBuffer(schema, buf, queries, out_buffers)) return false;
+  return LoadSelectResultBfbs(out_bfbs_buffer);
+}
+
+bool SelectColumnsForFlatbufferFiles(const std::string &bfbs_path,
+                                     const std::vector<std::string> &bin_paths,
+                                     const std::string &top_level_vector_field,
+                                     const std::vector<std::string> &columns,
+                                     const std::vector<SelectFilter> &filters,
+                                     const PipelineOptions &opts,
+                                     std::vector<std::vector<uint8_t>> &out_buffers,
+                                     std::vector<uint8_t> &out_bfbs_buffer,
+                                     const std::vector<SelectFilter> &shard_filters) {
+  out_buffers.assign(bin_paths.size(), std::vector<uint8_t>());
+  out_bfbs_buffer.clear();
+  std::string bfbs_data;
+  if (!LoadSelectSchema(bfbs_path, bfbs_data)) return false;
+  auto schema = reflection::GetSchema(bfbs_data.c_str());
+
+  std::vector<SelectQuery> queries(1);
+  queries[0].top_level_vector_field = top_level_vector_field;
+  queries[0].columns = columns;
+  queries[0].filters = filters;
+  if (!ValidateQueryFilters(schema, queries) || !ValidateShardFilters(schema, shard_filters)) return false;
+  // Element filters become "<vector>.<column>" stats paths; root-relative
+  // shard filters apply as given. All of them must hold.
+  std::vector<SelectFilter> prune_filters;
+  if (!filters.empty() && !ShardFiltersForVector(schema, top_level_vector_field, filters, prune_filters)) {
+    return false;
+  }
+  prune_filters.insert(prune_filters.end(), shard_filters.begin(), shard_filters.end());
+
+  struct LoadedBin {
+    bool ok = false;
+    bool skipped = false;
+    std::string data;
+  };
+  struct SelectedBin {
+    bool ok = false;
+    std::vector<uint8_t> buffer;
+  };
+
+  std::atomic<bool> all_ok{true};
+  auto read = [&](size_t i) {
+    LoadedBin loaded;
+    // Consult the stats sidecar before touching the data file.
+    if (!ShardMayMatch(bin_paths[i], prune_filters)) {
+      loaded.skipped = true;
+      return loaded;
+    }
+    loaded.ok = flatbuffers::LoadFile(bin_paths[i].c_str(), true, &loaded.data);
+    return loaded;
+  };
+  auto select = [&](size_t i, LoadedBin &loaded) {
+    SelectedBin selected;
+    if (loaded.skipped) {
+      EmptySelectResult(selected.buffer);
+      selected.ok = true;
+      return selected;
+    }
+    if (!loaded.ok) {
+      std::cerr << "SelectColumns: failed to load bin: " << bin_paths[i] << "\n";
+      return selected;
+    }
+    const uint8_t *buf = reinterpret_cast<const uint8_t *>(loaded.data.c_str());
+    std::vector<std::vector<uint8_t>> results;
+    selected.ok = SelectQueriesFromBuffer(schema, buf, queries, results);
+    if (selected.ok) selected.buffer = std::move(results[0]);
+    return selected;
+  };
+  auto emit = [&](size_t i, SelectedBin &selected) {
+    if (!selected.ok) all_ok.store(false, std::memory_order_relaxed);
+    out_buffers[i] = std::move(selected.buffer);
+  };
+
+  // Each result lands in its own slot, so the output stage need not reorder.
+  PipelineOptions select_opts = opts;
+  select_opts.ordered_output = false;
+  RunPipeline<LoadedBin, SelectedBin>(bin_paths.size(), read, select, emit, select_opts);
+
+  if (!LoadSelectResultBfbs(out_bfbs_buffer)) return false;
+  return all_ok.load();
+}
+
 int DecodeAndPrintFromBuffers(const std::string &bfbs_data, const std::vector<uint8_t> &data_buf) {
   auto schema = reflection::GetSchema(bfbs_data.c_str());
   if (!schema) {
@@ -1,18 +1,46 @@
 #pragma once
 
+#include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 #include "flatbuffers/reflection.h"
 #include "flatbuffers/flatbuffers.h"
+#include "reflection/pipeline.h"
+
+// Comparison applied by a SelectFilter.
+enum class SelectFilterOp { Eq, Ne, Lt, Le, Gt, Ge };
+
+// Keep only elements whose `column` compares to `value` with `op`. The value
+// is parsed according to the column's schema type: integers (or enum value
+// names), floating point, "true"/"false" for bools, or raw text for strings.
+// Elements where the column is missing, or is a floating-point NaN, never
+// match.
+struct SelectFilter {
+  std::string column;
+  SelectFilterOp op = SelectFilterOp::Eq;
+  std::string value;
+};
 
 // Print any table using the provided reflection schema/object/table.
 void PrintTable(const reflection::Schema *schema,
                 const reflection::Object *obj,
                 const flatbuffers::Table *t,
-                int indent);
+                int indent,
+                std::ostream &os = std::cout);
 
 // Load a .bfbs and a flatbuffer binary, then print its contents using reflection.
 int DecodeAndPrint(const std::string &bfbs_path, const std::string &bin_path);
 
+// Decode many (bfbs, bin) pairs with overlapping read/decode/print stages
+// (see `reflection/pipeline.h`). Each distinct schema is loaded once up front;
+// output is identical to calling DecodeAndPrint on each pair in order.
+// Binaries whose stats sidecar proves no row can satisfy `shard_filters`
+// (root-relative paths, see ShardMayMatch) are skipped without being read.
+int DecodeAndPrintPipelined(const std::vector<std::pair<std::string, std::string>> &pairs,
+                            const PipelineOptions &opts,
+                            const std::vector<SelectFilter> &shard_filters = {});
+
 
 // Select specific column names from a FlatBuffer binary using reflection.
 // The caller may optionally provide the name of the top-level vector field to
@@ -35,5 +63,157 @@ bool SelectColumnsForFlatbuffer(const std::string &bfbs_path,
                                 std::vector<uint8_t> &out_buffer,
                                 std::vector<uint8_t> &out_bfbs_buffer);
 
+// Ordering for SelectColumnsForFlatbufferSorted. `column` uses the same
+// (possibly nested) path syntax as the selected columns. Enum columns sort by
+// their numeric value. Elements missing the column, or holding a
+// floating-point NaN, sort last in either direction.
+struct SelectSort {
+  std::string column;
+  bool descending = false;
+  // Keep only the first `limit` rows (top-K); 0 sorts the whole vector.
+  size_t limit = 0;
+};
+
+// Like SelectColumnsForFlatbuffer, but rows come out ordered by `sort`. Only
+// (key, element index) pairs are built while ordering; result rows are
+// created just for the elements that survive the limit.
+bool SelectColumnsForFlatbufferSorted(const std::string &bfbs_path,
+                                      const std::string &bin_path,
+                                      const std::string &top_level_vector_field,
+                                      const std::vector<std::string> &columns,
+                                      const SelectSort &sort,
+                                      std::vector<uint8_t> &out_buffer,
+                                      std::vector<uint8_t> &out_bfbs_buffer);
+
+// A window of rows for SelectColumnsForFlatbufferPage. A non-empty `cursor`
+// (returned by a previous page) takes precedence over `offset`.
+struct SelectPage {
+  size_t offset = 0;
+  // Maximum rows to return; 0 returns everything from the start position.
+  size_t limit = 0;
+  std::string cursor;
+};
+
+// Like SelectColumnsForFlatbuffer, but only builds rows for the requested
+// window, jumping straight to it through the vector's random access.
+// `next_cursor` is set to an opaque token for the following page, or left
+// empty when this page reaches the end of the vector. A cursor is rejected
+// when the vector it was issued for has a different name, length or position
+// in the buffer; it cannot tell apart two binaries with identical layouts.
+// This overload reads both files on every call; to page through a large
+// binary, load it once and use the buffer overload below.
+bool SelectColumnsForFlatbufferPage(const std::string &bfbs_path,
+                                    const std::string &bin_path,
+                                    const std::string &top_level_vector_field,
+                                    const std::vector<std::string> &columns,
+                                    const SelectPage &page,
+                                    std::vector<uint8_t> &out_buffer,
+                                    std::vector<uint8_t> &out_bfbs_buffer,
+                                    std::string &next_cursor);
+
+// Page over an already-loaded schema (.bfbs bytes) and binary, e.g. one read
+// with flatbuffers::LoadFile or mapped into memory. `data` must stay valid for
+// the call. `out_bfbs_buffer` is only filled when empty, so reusing it across
+// pages loads the result schema once.
+bool SelectColumnsForFlatbufferPage(const std::string &bfbs_data,
+                                    const uint8_t *data,
+                                    const std::string &top_level_vector_field,
+                                    const std::vector<std::string> &columns,
+                                    const SelectPage &page,
+                                    std::vector<uint8_t> &out_buffer,
+                                    std::vector<uint8_t> &out_bfbs_buffer,
+                                    std::string &next_cursor);
+
+// One query of a batch select: the columns to return from a top-level vector
+// (empty name picks the first vector-of-objects, as in
+// SelectColumnsForFlatbuffer) for elements matching every filter.
+struct SelectQuery {
+  std::string top_level_vector_field;
+  std::vector<std::string> columns;
+  std::vector<SelectFilter> filters;
+};
+
+// Run many selects against one binary in a single pass per vector. Each
+// distinct column path is read at most once per element no matter how many
+// queries use it. `out_buffers[i]` receives the select_result for
+// `queries[i]`. The binary is not read, and every result is empty, when its
+// stats sidecar (see ShardMayMatch) rules out the root-relative
+// `shard_filters` (e.g. "timestamp" on a Telemetry capture) or, when every
+// query has filters, rules out each query. `shard_filters` only decide
+// whether the binary is read; they never filter rows.
+bool SelectColumnsForFlatbufferBatch(const std::string &bfbs_path,
+                                     const std::string &bin_path,
+                                     const std::vector<SelectQuery> &queries,
+                                     std::vector<std::vector<uint8_t>> &out_buffers,
+                                     std::vector<uint8_t> &out_bfbs_buffer,
+                                     const std::vector<SelectFilter> &shard_filters = {});
+
+// One input of HashJoinFlatbuffers.
+struct JoinSide {
+  std::string bfbs_path;
+  std::string bin_path;
+  // Vector-of-objects providing the rows (empty picks the first one, as in
+  // SelectColumnsForFlatbuffer).
+  std::string vector_field;
+  // Treat the root table as a single row instead of reading a vector, e.g.
+  // to join on Telemetry.device_id.
+  bool root_as_row = false;
+  // Column (possibly nested) whose values must be equal on both sides.
+  std::string key_column;
+  // Columns to emit from this side.
+  std::vector<std::string> columns;
+};
+
+// Inner equi-join of two inputs, which may come from different binaries and
+// schemas. Both binaries are loaded whole; the hash table is then built on the
+// smaller side's typed key values and the other side is streamed through it,
+// so no key strings are created and only the table scales with the build
+// side. Integer and floating-point keys compare by value across widths and
+// signedness; rows whose key is missing or NaN match nothing, and a string
+// key never matches a numeric one. Each result row holds the left side's
+// columns followed by the right side's, in select_result form.
+bool HashJoinFlatbuffers(const JoinSide &left,
+                         const JoinSide &right,
+                         std::vector<uint8_t> &out_buffer,
+                         std::vector<uint8_t> &out_bfbs_buffer);
+
+// Run the same select over many binaries sharing one schema, reading the next
+// files while earlier ones are being selected. Only elements matching every
+// filter are returned. Files whose stats sidecar proves that no element can
+// match `filters`, or that the root-relative `shard_filters` cannot hold, are
+// skipped before they are read (their result has no rows); as in
+// SelectColumnsForFlatbufferBatch, `shard_filters` never filter rows.
+// `out_buffers[i]` receives the result for `bin_paths[i]` (left empty if that
+// file failed). Returns false if any file failed.
+bool SelectColumnsForFlatbufferFiles(const std::string &bfbs_path,
+                                     const std::vector<std::string> &bin_paths,
+                                     const std::string &top_level_vector_field,
+                                     const std::vector<std::string> &columns,
+                                     const std::vector<SelectFilter> &filters,
+                                     const PipelineOptions &opts,
+                                     std::vector<std::vector<uint8_t>> &out_buffers,
+                                     std::vector<uint8_t> &out_bfbs_buffer,
+                                     const std::vector<SelectFilter> &shard_filters = {});
+
+// Path of the statistics sidecar for a binary: "<bin_path>.stats".
+std::string ShardStatsPath(const std::string &bin_path);
+
+// Compute min, max and null count for each root-relative path in `paths` and
+// write them (see `schema/shard_stats.fbs`) to `stats_path`, or to
+// ShardStatsPath(bin_path) when empty. Paths may pass through tables and
+// vectors of tables ("persons.age" covers every person) and must end at a
+// scalar or string field.
+bool WriteShardStats(const std::string &bfbs_path,
+                     const std::string &bin_path,
+                     const std::vector<std::string> &paths,
+                     const std::string &stats_path = "");
+
+// Check a binary's stats sidecar against filters whose columns are
+// root-relative stats paths. Returns false only when the stats prove that no
+// row can satisfy every filter. A missing, unreadable or out-of-date sidecar
+// (source size or last write time changed), or a path without stats, counts
+// as "may match".
+bool ShardMayMatch(const std::string &bin_path, const std::vector<SelectFilter> &filters);
+
 // Decode and print directly from in-memory bfbs (schema bytes) and a flatbuffer binary buffer.
 int DecodeAndPrintFromBuffers(const std::string &bfbs_data, const std::vector<uint8_t> &data_buf);
@@ -1,7 +1,67 @@
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
+#include "flatbuffers/util.h"
 #include "reflection/reflection_printer.h"
+#include "select_result_generated.h"
+#include "telemetry_generated.h"
+
+// Return the cells of column `col` from a select_result buffer.
+static std::vector<std::string> ColumnOf(const std::vector<uint8_t> &buf, size_t col) {
+  std::vector<std::string> out;
+  auto result = selectresult::GetResult(buf.data());
+  if (!result || !result->rows()) return out;
+  for (auto row : *result->rows()) {
+    out.push_back(row->cols() && col < row->cols()->size() ? row->cols()->Get(col)->str() : "");
+  }
+  return out;
+}
+
+static bool FileExists(const char *path) {
+  return std::ifstream(path).good();
+}
+
+// Write a one-capture telemetry binary with one sensor per value, named
+// "s0", "s1", ... in order.
+static bool WriteTelemetry(const char *path, const std::string &device_id, const std::vector<double> &values,
+                           uint64_t timestamp = 1630000000ULL) {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<telemetry::Sensor>> sensors;
+  for (size_t i = 0; i < values.size(); ++i) {
+    sensors.push_back(telemetry::CreateSensor(fbb, fbb.CreateString("s" + std::to_string(i)), values[i],
+                                              fbb.CreateString("C")));
+  }
+  auto root = telemetry::CreateTelemetry(fbb, timestamp, fbb.CreateString(device_id),
+                                         fbb.CreateVector(sensors), fbb.CreateString("OK"));
+  fbb.Finish(root);
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char *>(fbb.GetBufferPointer()), fbb.GetSize());
+  return out.good();
+}
+
+// Run `fn` with std::cout redirected and return what it printed.
+template <typename Fn>
+static std::string CaptureStdout(Fn fn) {
+  std::ostringstream captured;
+  std::streambuf *old = std::cout.rdbuf(captured.rdbuf());
+  fn();
+  std::cout.rdbuf(old);
+  return captured.str();
+}
+
+// Report a failed check; returns the value to OR into the exit code.
+static int Expect(bool cond, const char *what) {
+  if (!cond) std::fprintf(stderr, "FAILED: %s\n", what);
+  return cond ? 0 : 1;
+}
 
 int main() {
   // Use the generated bfbs and sample binary produced by the producer.
@@ -9,8 +69,329 @@ int main() {
   // write .bin files in the build directory when executed there. For this unit
   // test we will rely on that behavior.
   int rc = 0;
+  // The sample binaries come from the producers, which CTest runs first as
+  // the `sample_data` fixture. Fail rather than silently skipping checks.
+  const char *inputs[] = {"telemetry.bin", "people.bin", "devices.bin", "shapeholders.bin"};
+  for (const char *input : inputs) {
+    if (!FileExists(input)) {
+      std::fprintf(stderr, "FAILED: missing %s; run the producers in this directory first\n", input);
+      return 1;
+    }
+  }
+
   rc |= DecodeAndPrint(std::string("reflection/union_enum.bfbs"), std::string("union_enum.bin"));
   // For robustness run the telemetry example too (ensures existing behavior)
   rc |= DecodeAndPrint(std::string("reflection/telemetry.bfbs"), std::string("telemetry.bin"));
+
+  // Pipelined decode with more workers than files and a tiny queue must print
+  // exactly what the sequential decoder prints, in the same order.
+  std::vector<std::pair<std::string, std::string>> pairs = {
+    {"reflection/shapeholders.bfbs", "shapeholders.bin"},
+    {"reflection/telemetry.bfbs", "telemetry.bin"},
+    {"reflection/people.bfbs", "people.bin"},
+    {"reflection/devices.bfbs", "devices.bin"},
+    {"reflection/telemetry.bfbs", "telemetry.bin"}
+  };
+  std::string sequential = CaptureStdout([&]() {
+    for (const auto &pr : pairs) rc |= DecodeAndPrint(pr.first, pr.second);
+  });
+  PipelineOptions opts;
+  opts.reader_threads = 2;
+  opts.decode_threads = 3;
+  opts.output_threads = 2;
+  opts.queue_capacity = 1;
+  std::string pipelined = CaptureStdout([&]() { rc |= DecodeAndPrintPipelined(pairs, opts); });
+  rc |= Expect(!sequential.empty() && pipelined == sequential, "pipelined decode output matches sequential");
+
+  // Top-2 by age descending: Person_2 (22) then Person_1 (21).
+  std::vector<uint8_t> out_buf, out_bfbs;
+  SelectSort sort;
+  sort.column = "age";
+  sort.descending = true;
+  sort.limit = 2;
+  bool ok = SelectColumnsForFlatbufferSorted("reflection/people.bfbs", "people.bin", "persons",
+                                             {"name", "age"}, sort, out_buf, out_bfbs);
+  rc |= Expect(ok, "sorted select (top-K)");
+  rc |= Expect(ColumnOf(out_buf, 0) == std::vector<std::string>{"Person_2", "Person_1"}, "top-2 by age desc");
+  // Full ascending sort on a nested string column.
+  sort.column = "address.city";
+  sort.descending = false;
+  sort.limit = 0;
+  ok = SelectColumnsForFlatbufferSorted("reflection/people.bfbs", "people.bin", "persons",
+                                        {"name"}, sort, out_buf, out_bfbs);
+  rc |= Expect(ok, "sorted select (full)");
+  rc |= Expect(ColumnOf(out_buf, 0) == std::vector<std::string>{"Person_0", "Person_2", "Person_1"},
+               "full sort by address.city");
+
+  // Full numeric sorts go through the radix sort; ties keep vector order and
+  // NaN sorts last in both directions, as does a missing value.
+  ok = WriteTelemetry("telemetry_sort.bin", "dev_0", {5.0, std::nan(""), 2.0, 5.0, -1.0});
+  rc |= Expect(ok, "write telemetry_sort.bin");
+  sort.column = "value";
+  sort.descending = false;
+  sort.limit = 0;
+  ok = SelectColumnsForFlatbufferSorted("reflection/telemetry.bfbs", "telemetry_sort.bin", "sensors", {"id"},
+                                        sort, out_buf, out_bfbs);
+  rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"s4", "s2", "s0", "s3", "s1"},
+               "full numeric sort asc");
+  sort.descending = true;
+  ok = SelectColumnsForFlatbufferSorted("reflection/telemetry.bfbs", "telemetry_sort.bin", "sensors", {"id"},
+                                        sort, out_buf, out_bfbs);
+  rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"s0", "s3", "s2", "s4", "s1"},
+               "full numeric sort desc");
+  sort.limit = 2;
+  ok = SelectColumnsForFlatbufferSorted("reflection/telemetry.bfbs", "telemetry_sort.bin", "sensors", {"id"},
+                                        sort, out_buf, out_bfbs);
+  rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"s0", "s3"}, "top-2 skips NaN");
+  std::remove("telemetry_sort.bin");
+
+  // Two filtered queries sharing one scan.
+  std::vector<SelectQuery> queries(2);
+  queries[0].top_level_vector_field = "persons";
+  queries[0].columns = {"name", "age"};
+  queries[0].filters = {{"age", SelectFilterOp::Ge, "21"}};
+  queries[1].columns = {"name"};
+  queries[1].filters = {{"address.city", SelectFilterOp::Eq, "Metropolis"}};
+  std::vector<std::vector<uint8_t>> out_bufs;
+  ok = SelectColumnsForFlatbufferBatch("reflection/people.bfbs", "people.bin", queries, out_bufs, out_bfbs);
+  rc |= Expect(ok && out_bufs.size() == 2, "batch select");
+  if (ok) {
+    rc |= Expect(ColumnOf(out_bufs[0], 0) == std::vector<std::string>{"Person_1", "Person_2"}, "batch age >= 21");
+    rc |= Expect(ColumnOf(out_bufs[1], 0) == std::vector<std::string>{"Person_0", "Person_2"}, "batch city filter");
+  }
+
+  // Page through persons two at a time using cursors.
+  SelectPage page;
+  page.limit = 2;
+  std::string cursor;
+  ok = SelectColumnsForFlatbufferPage("reflection/people.bfbs", "people.bin", "persons", {"name"}, page,
+                                      out_buf, out_bfbs, cursor);
+  rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"Person_0", "Person_1"}, "first page");
+  rc |= Expect(!cursor.empty(), "first page cursor");
+  page.cursor = cursor;
+  ok = SelectColumnsForFlatbufferPage("reflection/people.bfbs", "people.bin", "persons", {"name"}, page,
+                                      out_buf, out_bfbs, cursor);
+  rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"Person_2"}, "last page");
+  rc |= Expect(cursor.empty(), "last page has no cursor");
+  page.cursor.clear();
+  page.offset = 1;
+  page.limit = 1;
+  ok = SelectColumnsForFlatbufferPage("reflection/people.bfbs", "people.bin", "persons", {"name"}, page,
+                                      out_buf, out_bfbs, cursor);
+  rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"Person_1"}, "offset/limit page");
+  // Paging over preloaded buffers matches the file-path overload and keeps
+  // the caller's result schema.
+  std::string people_bfbs, people_bin;
+  ok = flatbuffers::LoadFile("reflection/people.bfbs", true, &people_bfbs) &&
+       flatbuffers::LoadFile("people.bin", true, &people_bin);
+  rc |= Expect(ok, "load people for buffer paging");
+  if (ok) {
+    const uint8_t *people_data = reinterpret_cast<const uint8_t *>(people_bin.data());
+    page.offset = 0;
+    page.limit = 2;
+    std::vector<uint8_t> page_bfbs;
+    ok = SelectColumnsForFlatbufferPage(people_bfbs, people_data, "persons", {"name"}, page, out_buf,
+                                        page_bfbs, cursor);
+    rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"Person_0", "Person_1"} &&
+                 page_bfbs == out_bfbs, "buffer first page");
+    page.cursor = cursor;
+    ok = SelectColumnsForFlatbufferPage(people_bfbs, people_data, "persons", {"name"}, page, out_buf,
+                                        page_bfbs, cursor);
+    rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"Person_2"} && cursor.empty() &&
+                 page_bfbs == out_bfbs, "buffer last page");
+  }
+  // A cursor from one capture is refused by another of the same length.
+  SelectPage tel_page;
+  tel_page.limit = 1;
+  ok = WriteTelemetry("telemetry_page.bin", "dev_0", {1.0, 2.0, 3.0}) &&
+       SelectColumnsForFlatbufferPage("reflection/telemetry.bfbs", "telemetry_page.bin", "sensors", {"id"}, tel_page,
+                                      out_buf, out_bfbs, cursor);
+  rc |= Expect(ok && !cursor.empty(), "telemetry first page");
+  tel_page.cursor = cursor;
+  ok = WriteTelemetry("telemetry_page.bin", "a-much-longer-device-id", {1.0, 2.0, 3.0}) &&
+       SelectColumnsForFlatbufferPage("reflection/telemetry.bfbs", "telemetry_page.bin", "sensors", {"id"}, tel_page,
+                                      out_buf, out_bfbs, cursor);
+  rc |= Expect(!ok, "cursor rejected for other data of the same length");
+  std::remove("telemetry_page.bin");
+
+  // Self-join on city: rows follow the probe (right) side, matches in build order.
+  JoinSide left;
+  left.bfbs_path = "reflection/people.bfbs";
+  left.bin_path = "people.bin";
+  left.vector_field = "persons";
+  left.key_column = "address.city";
+  left.columns = {"name"};
+  JoinSide right = left;
+  right.columns = {"name", "age"};
+  ok = HashJoinFlatbuffers(left, right, out_buf, out_bfbs);
+  rc |= Expect(ok, "hash join");
+  if (ok) {
+    rc |= Expect(ColumnOf(out_buf, 0) == std::vector<std::string>{"Person_0", "Person_2", "Person_1", "Person_0", "Person_2"},
+                 "join left column");
+    rc |= Expect(ColumnOf(out_buf, 1) == std::vector<std::string>{"Person_0", "Person_0", "Person_1", "Person_2", "Person_2"},
+                 "join right column");
+    rc |= Expect(ColumnOf(out_buf, 2) == std::vector<std::string>{"20", "20", "21", "22", "22"}, "join right age");
+  }
+  left.key_column = "address";
+  rc |= Expect(!HashJoinFlatbuffers(left, right, out_buf, out_bfbs), "join rejects table key");
+
+  // Root-as-row join across schemas: one telemetry capture tagged with its device.
+  JoinSide tel;
+  tel.bfbs_path = "reflection/telemetry.bfbs";
+  tel.bin_path = "telemetry_join.bin";
+  tel.root_as_row = true;
+  tel.key_column = "device_id";
+  tel.columns = {"timestamp", "status"};
+  JoinSide dev;
+  dev.bfbs_path = "reflection/devices.bfbs";
+  dev.bin_path = "devices.bin";
+  dev.vector_field = "devices";
+  dev.key_column = "device_id";
+  dev.columns = {"device_id"};
+  ok = WriteTelemetry(tel.bin_path.c_str(), "dev_1", {23.5}) && HashJoinFlatbuffers(tel, dev, out_buf, out_bfbs);
+  rc |= Expect(ok, "root-as-row join");
+  if (ok) {
+    rc |= Expect(ColumnOf(out_buf, 0) == std::vector<std::string>{"1630000000"} &&
+                 ColumnOf(out_buf, 1) == std::vector<std::string>{"OK"} &&
+                 ColumnOf(out_buf, 2) == std::vector<std::string>{"dev_1"}, "telemetry joined to device");
+  }
+  tel.key_column = "sensors";
+  rc |= Expect(!HashJoinFlatbuffers(tel, dev, out_buf, out_bfbs), "join rejects vector key");
+  // NaN keys match nothing, not even each other.
+  JoinSide sensors;
+  sensors.bfbs_path = "reflection/telemetry.bfbs";
+  sensors.bin_path = "telemetry_join.bin";
+  sensors.vector_field = "sensors";
+  sensors.key_column = "value";
+  sensors.columns = {"id"};
+  ok = WriteTelemetry(sensors.bin_path.c_str(), "dev_0", {std::nan(""), 1.0, std::nan("")}) &&
+       HashJoinFlatbuffers(sensors, sensors, out_buf, out_bfbs);
+  rc |= Expect(ok && ColumnOf(out_buf, 0) == std::vector<std::string>{"s1"}, "NaN join keys match nothing");
+  std::remove("telemetry_join.bin");
+
+  // Zone maps: ages are 20..22 and names Person_0..Person_2.
+  rc |= Expect(WriteShardStats("reflection/people.bfbs", "people.bin", {"persons.age", "persons.name"}),
+               "write shard stats");
+  rc |= Expect(!ShardMayMatch("people.bin", {{"persons.age", SelectFilterOp::Gt, "60"}}), "stats prune age > 60");
+  rc |= Expect(ShardMayMatch("people.bin", {{"persons.age", SelectFilterOp::Ge, "22"}}), "stats keep age >= 22");
+  rc |= Expect(!ShardMayMatch("people.bin", {{"persons.name", SelectFilterOp::Eq, "Zed"}}), "stats prune name");
+  rc |= Expect(ShardMayMatch("people.bin", {{"persons.id", SelectFilterOp::Eq, "1"}}), "no stats for path");
+  // A rewrite that keeps the size must still invalidate the sidecar.
+  const char *shard = "telemetry_shard.bin";
+  ok = WriteTelemetry(shard, "dev_0", {20.0, 21.0}) &&
+       WriteShardStats("reflection/telemetry.bfbs", shard, {"sensors.value"});
+  rc |= Expect(ok && !ShardMayMatch(shard, {{"sensors.value", SelectFilterOp::Gt, "60"}}), "stats prune fresh shard");
+  auto old_size = std::filesystem::file_size(shard);
+  auto old_mtime = std::filesystem::last_write_time(shard);
+  ok = WriteTelemetry(shard, "dev_0", {70.0, 21.0});
+  // Filesystem timestamps can be coarse; make sure this rewrite is visible.
+  std::filesystem::last_write_time(shard, old_mtime + std::chrono::seconds(2));
+  rc |= Expect(ok && std::filesystem::file_size(shard) == old_size, "same-size rewrite");
+  rc |= Expect(ShardMayMatch(shard, {{"sensors.value", SelectFilterOp::Gt, "60"}}), "stale stats do not prune");
+  std::remove(shard);
+  std::remove(ShardStatsPath(shard).c_str());
+
+  // A leading NaN must not pin min/max, and NaN rows match no filter.
+  ok = WriteTelemetry(shard, "dev_0", {std::nan(""), 5.0}) &&
+       WriteShardStats("reflection/telemetry.bfbs", shard, {"sensors.value"});
+  rc |= Expect(ok && ShardMayMatch(shard, {{"sensors.value", SelectFilterOp::Gt, "3"}}), "NaN keeps value > 3");
+  rc |= Expect(!ShardMayMatch(shard, {{"sensors.value", SelectFilterOp::Gt, "6"}}), "NaN stats prune value > 6");
+  // Without a sidecar the binary is always read, so these exercise the row
+  // filter itself: s0 (NaN) must fail every comparison.
+  std::remove(ShardStatsPath(shard).c_str());
+  std::vector<SelectQuery> nan_queries(3);
+  for (auto &q : nan_queries) q.columns = {"id"};
+  nan_queries[0].filters = {{"value", SelectFilterOp::Ge, "-1000"}};
+  nan_queries[1].filters = {{"value", SelectFilterOp::Le, "1000"}};
+  nan_queries[2].filters = {{"value", SelectFilterOp::Ne, "5"}};
+  std::vector<std::vector<uint8_t>> nan_bufs;
+  ok = SelectColumnsForFlatbufferBatch("reflection/telemetry.bfbs", shard, nan_queries, nan_bufs, out_bfbs);
+  rc |= Expect(ok && nan_bufs.size() == 3, "NaN batch select");
+  if (ok) {
+    rc |= Expect(ColumnOf(nan_bufs[0], 0) == std::vector<std::string>{"s1"}, "NaN fails >=");
+    rc |= Expect(ColumnOf(nan_bufs[1], 0) == std::vector<std::string>{"s1"}, "NaN fails <=");
+    rc |= Expect(ColumnOf(nan_bufs[2], 0).empty(), "NaN fails !=");
+  }
+  std::remove(shard);
+
+  std::vector<std::vector<uint8_t>> file_bufs;
+  PipelineOptions file_opts;
+  // Element-filter pruning returns what the row filter would; whether a file
+  // was actually skipped is checked by the decode and timestamp cases below.
+  ok = SelectColumnsForFlatbufferFiles("reflection/people.bfbs", {"people.bin", "people.bin"}, "persons", {"name"},
+                                       {{"age", SelectFilterOp::Gt, "60"}}, file_opts, file_bufs, out_bfbs);
+  rc |= Expect(ok && file_bufs.size() == 2 && ColumnOf(file_bufs[0], 0).empty(), "pruned files select");
+  ok = SelectColumnsForFlatbufferFiles("reflection/people.bfbs", {"people.bin"}, "persons", {"name"},
+                                       {{"age", SelectFilterOp::Ge, "21"}}, file_opts, file_bufs, out_bfbs);
+  rc |= Expect(ok && ColumnOf(file_bufs[0], 0) == std::vector<std::string>{"Person_1", "Person_2"},
+               "filtered files select");
+
+  // Decoding prints every binary it reads, so here a skip is visible: the
+  // copy of people.bin disappears from the output only while a current
+  // sidecar rules it out.
+  const char *people_shard = "people_shard.bin";
+  std::filesystem::copy_file("people.bin", people_shard, std::filesystem::copy_options::overwrite_existing);
+  std::remove(ShardStatsPath(people_shard).c_str());
+  const std::vector<std::pair<std::string, std::string>> shard_pairs = {{"reflection/people.bfbs", people_shard}};
+  const std::vector<SelectFilter> over_60 = {{"persons.age", SelectFilterOp::Gt, "60"}};
+  auto decode_shard = [&]() {
+    return CaptureStdout([&]() { rc |= DecodeAndPrintPipelined(shard_pairs, PipelineOptions(), over_60); });
+  };
+  rc |= Expect(decode_shard().find("Person_0") != std::string::npos, "decode reads shard without sidecar");
+  rc |= Expect(WriteShardStats("reflection/people.bfbs", people_shard, {"persons.age"}), "write people_shard stats");
+  rc |= Expect(decode_shard().find("people_shard.bin") == std::string::npos, "decode skips pruned shard");
+  std::filesystem::last_write_time(people_shard,
+                                   std::filesystem::last_write_time(people_shard) + std::chrono::seconds(2));
+  rc |= Expect(decode_shard().find("Person_0") != std::string::npos, "decode reads shard with stale sidecar");
+  std::remove(people_shard);
+  std::remove(ShardStatsPath(people_shard).c_str());
+  // Batch select skips the binary only when the stats rule out every query.
+  std::vector<SelectQuery> pruned(2);
+  pruned[0].top_level_vector_field = "persons";
+  pruned[0].columns = {"name"};
+  pruned[0].filters = {{"age", SelectFilterOp::Gt, "60"}};
+  pruned[1].columns = {"name"};
+  pruned[1].filters = {{"name", SelectFilterOp::Eq, "Zed"}};
+  ok = SelectColumnsForFlatbufferBatch("reflection/people.bfbs", "people.bin", pruned, out_bufs, out_bfbs);
+  rc |= Expect(ok && out_bufs.size() == 2 && ColumnOf(out_bufs[0], 0).empty() && ColumnOf(out_bufs[1], 0).empty() &&
+               !out_bfbs.empty(), "batch pruned by stats");
+  pruned[1].filters = {{"age", SelectFilterOp::Ge, "22"}};
+  ok = SelectColumnsForFlatbufferBatch("reflection/people.bfbs", "people.bin", pruned, out_bufs, out_bfbs);
+  rc |= Expect(ok && ColumnOf(out_bufs[0], 0).empty() && ColumnOf(out_bufs[1], 0) == std::vector<std::string>{"Person_2"},
+               "batch not pruned when one query may match");
+  // Root-level shard filters skip whole captures whose timestamp is out of
+  // range, even though their rows would otherwise be returned.
+  const std::vector<std::string> captures = {"telemetry_t1.bin", "telemetry_t2.bin"};
+  ok = WriteTelemetry(captures[0].c_str(), "dev_0", {1.0, 2.0}, 1000) &&
+       WriteTelemetry(captures[1].c_str(), "dev_0", {3.0}, 2000) &&
+       WriteShardStats("reflection/telemetry.bfbs", captures[0], {"timestamp"}) &&
+       WriteShardStats("reflection/telemetry.bfbs", captures[1], {"timestamp"});
+  rc |= Expect(ok, "write timestamped captures");
+  const std::vector<SelectFilter> window = {{"timestamp", SelectFilterOp::Ge, "1500"}};
+  ok = SelectColumnsForFlatbufferFiles("reflection/telemetry.bfbs", captures, "sensors", {"id"}, {}, PipelineOptions(),
+                                       file_bufs, out_bfbs, window);
+  rc |= Expect(ok && file_bufs.size() == 2 && ColumnOf(file_bufs[0], 0).empty() &&
+               ColumnOf(file_bufs[1], 0) == std::vector<std::string>{"s0"}, "files pruned by timestamp");
+  std::vector<SelectQuery> all_sensors(1);
+  all_sensors[0].columns = {"id"};
+  ok = SelectColumnsForFlatbufferBatch("reflection/telemetry.bfbs", captures[0], all_sensors, out_bufs, out_bfbs, window);
+  rc |= Expect(ok && ColumnOf(out_bufs[0], 0).empty(), "batch pruned by timestamp");
+  ok = SelectColumnsForFlatbufferBatch("reflection/telemetry.bfbs", captures[1], all_sensors, out_bufs, out_bfbs, window);
+  rc |= Expect(ok && ColumnOf(out_bufs[0], 0) == std::vector<std::string>{"s0"}, "batch kept by timestamp");
+  rc |= Expect(!SelectColumnsForFlatbufferBatch("reflection/telemetry.bfbs", captures[1], all_sensors, out_bufs,
+                                                out_bfbs, {{"sensors", SelectFilterOp::Eq, "1"}}),
+               "batch rejects non-leaf shard filter");
+  for (const auto &capture : captures) {
+    std::remove(capture.c_str());
+    std::remove(ShardStatsPath(capture).c_str());
+  }
+
+  // Bad filters fail the same way whether or not the stats would prune.
+  pruned[1].filters = {{"age", SelectFilterOp::Gt, "sixty"}};
+  rc |= Expect(!SelectColumnsForFlatbufferBatch("reflection/people.bfbs", "people.bin", pruned, out_bufs, out_bfbs),
+               "pruned batch rejects bad literal");
+  pruned[1].filters = {{"height", SelectFilterOp::Gt, "60"}};
+  rc |= Expect(!SelectColumnsForFlatbufferBatch("reflection/people.bfbs", "people.bin", pruned, out_bufs, out_bfbs),
+               "pruned batch rejects unknown column");
   return rc;
 }